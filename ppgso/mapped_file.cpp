@@ -0,0 +1,83 @@
+#include <fstream>
+#include <sstream>
+#include <stdexcept>
+
+#ifdef _WIN32
+#define WIN32_LEAN_AND_MEAN
+#define NOMINMAX
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#endif
+
+#include "mapped_file.h"
+
+ppgso::MappedFile::MappedFile(const std::string &path) {
+  std::stringstream msg;
+  msg << "Could not map file " << path;
+
+#ifdef _WIN32
+  file = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+  if (file == INVALID_HANDLE_VALUE) {
+    file = nullptr;
+    throw std::runtime_error(msg.str());
+  }
+
+  LARGE_INTEGER file_size;
+  GetFileSizeEx(file, &file_size);
+  length = (size_t) file_size.QuadPart;
+  if (length == 0) return;
+
+  mapping = CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+  if (mapping)
+    bytes = (const uint8_t *) MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+  if (!bytes) {
+    if (mapping) CloseHandle(mapping);
+    CloseHandle(file);
+    throw std::runtime_error(msg.str());
+  }
+#else
+  descriptor = open(path.c_str(), O_RDONLY);
+  if (descriptor < 0)
+    throw std::runtime_error(msg.str());
+
+  struct stat file_stat = {};
+  fstat(descriptor, &file_stat);
+  length = (size_t) file_stat.st_size;
+  if (length == 0) return;
+
+  auto address = mmap(nullptr, length, PROT_READ, MAP_PRIVATE, descriptor, 0);
+  if (address == MAP_FAILED) {
+    close(descriptor);
+    throw std::runtime_error(msg.str());
+  }
+  bytes = (const uint8_t *) address;
+#endif
+}
+
+ppgso::MappedFile::~MappedFile() {
+#ifdef _WIN32
+  if (bytes) UnmapViewOfFile(bytes);
+  if (mapping) CloseHandle(mapping);
+  if (file) CloseHandle(file);
+#else
+  if (bytes) munmap((void *) bytes, length);
+  if (descriptor >= 0) close(descriptor);
+#endif
+}
+
+const uint8_t *ppgso::MappedFile::data() const {
+  return bytes;
+}
+
+size_t ppgso::MappedFile::size() const {
+  return length;
+}
+
+bool ppgso::MappedFile::exists(const std::string &path) {
+  std::ifstream file(path, std::ios::binary);
+  return file.is_open();
+}
@@ -0,0 +1,59 @@
+#pragma once
+#include <string>
+#include <cstdint>
+#include <cstddef>
+
+namespace ppgso {
+
+  /*!
+   * Read-only memory mapping of a whole file.
+   * The contents stay valid for the lifetime of the object and are paged in by the OS on first access.
+   */
+  class MappedFile {
+  public:
+
+    /*!
+     * Map file into memory.
+     *
+     * @param path - File path to the file to map.
+     */
+    MappedFile(const std::string &path);
+
+    ~MappedFile();
+
+    MappedFile(const MappedFile&) = delete;
+    MappedFile &operator=(const MappedFile&) = delete;
+
+    /*!
+     * Get pointer to the first byte of the mapped file.
+     *
+     * @return - Pointer to the mapped contents.
+     */
+    const uint8_t *data() const;
+
+    /*!
+     * Get size of the mapped file.
+     *
+     * @return - Size in bytes.
+     */
+    size_t size() const;
+
+    /*!
+     * Check if a file exists and can be opened for reading.
+     *
+     * @param path - File path to check.
+     * @return - True when the file can be mapped.
+     */
+    static bool exists(const std::string &path);
+
+  private:
+    const uint8_t *bytes = nullptr;
+    size_t length = 0;
+#ifdef _WIN32
+    void *file = nullptr;
+    void *mapping = nullptr;
+#else
+    int descriptor = -1;
+#endif
+  };
+}
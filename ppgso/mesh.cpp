@@ -1,87 +1,149 @@
 #include <glm/glm.hpp>
-#include <sstream>
+#include <algorithm>
+#include <cstddef>
 
 #include "mesh.h"
 
-ppgso::Mesh::Mesh(const std::string &obj_file) {
-  // Load OBJ file
-  shapes.clear();
-  materials.clear();
-  std::string err = tinyobj::LoadObj(shapes, materials, obj_file.c_str());
+ppgso::Mesh::Mesh(const std::string &obj_file) : Mesh(MeshData::load(obj_file)) {}
 
-  if (!err.empty()) {
-    std::stringstream msg;
-    msg << err << std::endl << "Failed to load OBJ file " << obj_file << "!" << std::endl;
-    throw std::runtime_error(msg.str());
-  }
+ppgso::Mesh::Mesh(const MeshData &data) {
+  upload(data);
+}
 
-  // Initialize OpenGL Buffers
-  for(auto& shape : shapes) {
-    gl_buffer buffer;
+void ppgso::Mesh::upload(const MeshData &data) {
+  release();
 
-    if(!shape.mesh.positions.empty()) {
-      // Generate a vertex array object
-      glGenVertexArrays(1, &buffer.vao);
-      glBindVertexArray(buffer.vao);
+  boundsMin = data.min;
+  boundsMax = data.max;
+  boundsCenter = data.center;
+  boundsRadius = data.radius;
 
-      // Generate and upload a buffer with vertex positions to GPU
-      glGenBuffers(1, &buffer.vbo);
-      glBindBuffer(GL_ARRAY_BUFFER, buffer.vbo);
-      glBufferData(GL_ARRAY_BUFFER, shape.mesh.positions.size() * sizeof(float), shape.mesh.positions.data(),
-                   GL_STATIC_DRAW);
+  for (uint32_t level = 0; level < data.levelCount(); level++)
+    levelErrors.push_back(data.levelError(level));
 
-      // Bind the buffer to "Position" attribute in program
-      glEnableVertexAttribArray(0);
-      glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, 0, nullptr);
-    }
+  // Initialize OpenGL Buffers
+  for(auto& shape : data.shapes) {
+    if(shape.vertexCount == 0) continue;
 
-    if(!shape.mesh.texcoords.empty()) {
-      // Generate and upload a buffer with texture coordinates to GPU
-      glGenBuffers(1, &buffer.tbo);
-      glBindBuffer(GL_ARRAY_BUFFER, buffer.tbo);
-      glBufferData(GL_ARRAY_BUFFER, shape.mesh.texcoords.size() * sizeof(float), shape.mesh.texcoords.data(),
-                   GL_STATIC_DRAW);
+    gl_buffer buffer;
 
-      glEnableVertexAttribArray(1);
-      glVertexAttribPointer(1, 2, GL_FLOAT, GL_FALSE, 0, nullptr);
-    }
+    // Generate a vertex array object
+    glGenVertexArrays(1, &buffer.vao);
+    glBindVertexArray(buffer.vao);
 
-    if(!shape.mesh.normals.empty()) {
-      // Generate and upload a buffer with texture coordinates to GPU
-      glGenBuffers(1, &buffer.nbo);
-      glBindBuffer(GL_ARRAY_BUFFER, buffer.nbo);
-      glBufferData(GL_ARRAY_BUFFER, shape.mesh.normals.size() * sizeof(float), shape.mesh.normals.data(),
-                   GL_STATIC_DRAW);
+    // Generate and upload a buffer with interleaved vertex data to GPU
+    glGenBuffers(1, &buffer.vbo);
+    glBindBuffer(GL_ARRAY_BUFFER, buffer.vbo);
+    glBufferData(GL_ARRAY_BUFFER, shape.vertexCount * sizeof(PackedVertex), shape.vertices, GL_STATIC_DRAW);
 
-      glEnableVertexAttribArray(2);
-      glVertexAttribPointer(2, 3, GL_FLOAT, GL_FALSE, 0, nullptr);
-    }
+    // Bind the buffer to "Position", "TexCoord" and "Normal" attributes in program, the shaders see them as floats
+    glEnableVertexAttribArray(0);
+    glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, sizeof(PackedVertex), (void *) offsetof(PackedVertex, position));
+    glEnableVertexAttribArray(1);
+    glVertexAttribPointer(1, 2, GL_HALF_FLOAT, GL_FALSE, sizeof(PackedVertex), (void *) offsetof(PackedVertex, texCoord));
+    glEnableVertexAttribArray(2);
+    glVertexAttribPointer(2, 4, GL_INT_2_10_10_10_REV, GL_TRUE, sizeof(PackedVertex), (void *) offsetof(PackedVertex, normal));
 
     // Generate and upload a buffer with indices to GPU
     glGenBuffers(1, &buffer.ibo);
     glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, buffer.ibo);
-    glBufferData(GL_ELEMENT_ARRAY_BUFFER, shape.mesh.indices.size() * sizeof(unsigned int), shape.mesh.indices.data(), GL_STATIC_DRAW);
-    buffer.size = (GLsizei) shape.mesh.indices.size();
+    glBufferData(GL_ELEMENT_ARRAY_BUFFER, shape.indexCount * shape.indexSize, shape.indices, GL_STATIC_DRAW);
+    buffer.size = (GLsizei) shape.indexCount;
+    buffer.indexType = shape.indexSize == sizeof(uint16_t) ? GL_UNSIGNED_SHORT : GL_UNSIGNED_INT;
+    buffer.indexSize = (GLsizei) shape.indexSize;
+    if (shape.levelCount > 0)
+      buffer.levels.assign(shape.levels, shape.levels + shape.levelCount);
+    else
+      buffer.levels.push_back(MeshLevel{0, shape.indexCount, 0, 0});
 
     // Copy it to the end of the buffers vector
     buffers.push_back(buffer);
   }
+  glBindVertexArray(0);
+
+  bindInstanceAttributes();
+}
+
+void ppgso::Mesh::setInstanceBuffer(GLuint buffer, GLsizei stride, const std::vector<InstanceAttribute> &attributes) {
+  instanceBuffer = buffer;
+  instanceStride = stride;
+  instanceAttributes = attributes;
+  bindInstanceAttributes();
+}
+
+void ppgso::Mesh::bindInstanceAttributes() {
+  if (instanceBuffer == 0) return;
+
+  for(auto& buffer : buffers) {
+    glBindVertexArray(buffer.vao);
+    glBindBuffer(GL_ARRAY_BUFFER, instanceBuffer);
+    for(auto& attribute : instanceAttributes) {
+      glEnableVertexAttribArray(attribute.location);
+      glVertexAttribPointer(attribute.location, attribute.components, GL_FLOAT, GL_FALSE, instanceStride, (void *) attribute.offset);
+      glVertexAttribDivisor(attribute.location, 1);
+    }
+  }
+  glBindVertexArray(0);
 }
 
 ppgso::Mesh::~Mesh() {
+  release();
+}
+
+void ppgso::Mesh::release() {
   for(auto& buffer : buffers) {
     glDeleteBuffers(1, &buffer.ibo);
-    glDeleteBuffers(1, &buffer.nbo);
-    glDeleteBuffers(1, &buffer.tbo);
     glDeleteBuffers(1, &buffer.vbo);
     glDeleteVertexArrays(1, &buffer.vao);
   }
+  buffers.clear();
+  levelErrors.clear();
+}
+
+bool ppgso::Mesh::empty() const {
+  return buffers.empty();
+}
+
+const glm::vec3 &ppgso::Mesh::getBoundsMin() const {
+  return boundsMin;
+}
+
+const glm::vec3 &ppgso::Mesh::getBoundsMax() const {
+  return boundsMax;
+}
+
+const glm::vec3 &ppgso::Mesh::getBoundingCenter() const {
+  return boundsCenter;
+}
+
+float ppgso::Mesh::getBoundingRadius() const {
+  return boundsRadius;
+}
+
+size_t ppgso::Mesh::getLevelCount() const {
+  return levelErrors.empty() ? 1 : levelErrors.size();
+}
+
+float ppgso::Mesh::getLevelError(size_t level) const {
+  if (levelErrors.empty()) return 0;
+  return levelErrors[std::min(level, levelErrors.size() - 1)];
+}
+
+void ppgso::Mesh::renderInstanced(GLsizei count, size_t level) {
+  for(auto& buffer : buffers) {
+    // Draw all instances of the object
+    auto &range = buffer.levels[std::min(level, buffer.levels.size() - 1)];
+    glBindVertexArray(buffer.vao);
+    glDrawElementsInstanced(GL_TRIANGLES, (GLsizei) range.indexCount, buffer.indexType,
+                            (void *) ((size_t) range.firstIndex * buffer.indexSize), count);
+  }
 }
 
-void ppgso::Mesh::render() {
+void ppgso::Mesh::render(size_t level) {
   for(auto& buffer : buffers) {
     // Draw object
+    auto &range = buffer.levels[std::min(level, buffer.levels.size() - 1)];
     glBindVertexArray(buffer.vao);
-    glDrawElements(GL_TRIANGLES, buffer.size, GL_UNSIGNED_INT, nullptr);
+    glDrawElements(GL_TRIANGLES, (GLsizei) range.indexCount, buffer.indexType, (void *) ((size_t) range.firstIndex * buffer.indexSize));
   }
 }
@@ -11,40 +11,160 @@
 
 #include "shader.h"
 #include "texture.h"
+#include "mesh_data.h"
 #include "tiny_obj_loader.h"
 
 namespace ppgso {
 
+  /*!
+   * Per-instance vertex attribute read from an instance buffer.
+   */
+  struct InstanceAttribute {
+    GLuint location;
+    GLint components;
+    size_t offset;
+  };
+
   class Mesh {
     struct gl_buffer {
     public:
-      GLuint vao, vbo, tbo, nbo, ibo = 0;
+      GLuint vao = 0, vbo = 0, ibo = 0;
       GLsizei size = 0;
+      // GL_UNSIGNED_SHORT or GL_UNSIGNED_INT, and the size of one index in bytes
+      GLenum indexType = GL_UNSIGNED_INT;
+      GLsizei indexSize = sizeof(GLuint);
+      // Ranges of the index buffer drawn for each level of detail
+      std::vector<MeshLevel> levels;
     };
-    std::vector<tinyobj::shape_t> shapes;
-    std::vector<tinyobj::material_t> materials;
     std::vector<gl_buffer> buffers;
+    std::vector<float> levelErrors;
+
+    glm::vec3 boundsMin{0, 0, 0};
+    glm::vec3 boundsMax{0, 0, 0};
+    glm::vec3 boundsCenter{0, 0, 0};
+    float boundsRadius = 0;
+
+    GLuint instanceBuffer = 0;
+    GLsizei instanceStride = 0;
+    std::vector<InstanceAttribute> instanceAttributes;
+
+    void release();
+    void bindInstanceAttributes();
 
   public:
 
     /*!
      * Load 3D geometry from a na Wavefront .obj file.
+     * When a precompiled binary .mesh file with the same name exists it is memory mapped instead of parsing the obj file.
      *
      * The shader program passed to the object will be bound to the geometry as follows:
      * vec3 Position - Vertex position, position 0
-     * vec2 TexCoord - Texture coordinate, position 1
-     * vec3 Normal - Normal vector, position 2
+     * vec2 TexCoord - Texture coordinate, position 1, stored as half floats
+     * vec3 Normal - Normal vector, position 2, stored as signed normalized 10:10:10:2
      *
      * @param obj - File path to the obj file to load.
      */
     Mesh(const std::string &obj);
 
+    /*!
+     * Upload already loaded geometry to the GPU.
+     *
+     * @param data - Geometry to upload.
+     */
+    Mesh(const MeshData &data);
+
+    /*!
+     * Create an empty mesh that renders nothing until geometry is uploaded.
+     */
+    Mesh() = default;
+
     ~Mesh();
 
+    Mesh(const Mesh&) = delete;
+    Mesh &operator=(const Mesh&) = delete;
+
+    /*!
+     * Replace the geometry of the mesh, previous GPU buffers are released.
+     * Needs to be called from the thread that owns the OpenGL context.
+     *
+     * @param data - Geometry to upload.
+     */
+    void upload(const MeshData &data);
+
+    /*!
+     * Check if the mesh has any geometry uploaded.
+     *
+     * @return - True when there is nothing to render.
+     */
+    bool empty() const;
+
+    /*!
+     * Get the corner of the axis aligned bounding box with the smallest coordinates, in model space.
+     *
+     * @return - Minimum corner, the origin until geometry is uploaded.
+     */
+    const glm::vec3 &getBoundsMin() const;
+
+    /*!
+     * Get the corner of the axis aligned bounding box with the largest coordinates, in model space.
+     *
+     * @return - Maximum corner, the origin until geometry is uploaded.
+     */
+    const glm::vec3 &getBoundsMax() const;
+
+    /*!
+     * Get the center of the bounding sphere in model space.
+     *
+     * @return - Center of the bounding box.
+     */
+    const glm::vec3 &getBoundingCenter() const;
+
+    /*!
+     * Get the radius of the bounding sphere in model space.
+     *
+     * @return - Radius enclosing all vertices, zero until geometry is uploaded.
+     */
+    float getBoundingRadius() const;
+
+    /*!
+     * Get number of levels of detail the geometry was uploaded with.
+     *
+     * @return - Number of levels, 1 for geometry without simplified levels.
+     */
+    size_t getLevelCount() const;
+
+    /*!
+     * Get how far a level of detail deviates from the full detail geometry.
+     *
+     * @param level - Level of detail, 0 is the full detail.
+     * @return - Largest deviation in model space.
+     */
+    float getLevelError(size_t level) const;
+
     /*!
      * Render the geometry associated with the mesh using glDrawElements.
+     *
+     * @param level - Level of detail to draw, clamped to the coarsest one.
+     */
+    void render(size_t level = 0);
+
+    /*!
+     * Attach a buffer with per-instance data to the geometry, the attributes advance once per instance.
+     * The buffer stays attached when the geometry is replaced by upload.
+     *
+     * @param buffer - OpenGL buffer holding the instance data.
+     * @param stride - Size of the data of one instance in bytes.
+     * @param attributes - Attributes to read from the buffer, matrices take one location per column.
+     */
+    void setInstanceBuffer(GLuint buffer, GLsizei stride, const std::vector<InstanceAttribute> &attributes);
+
+    /*!
+     * Render multiple instances of the geometry using glDrawElementsInstanced.
+     *
+     * @param count - Number of instances in the attached instance buffer to render.
+     * @param level - Level of detail to draw, clamped to the coarsest one.
      */
-    void render();
+    void renderInstanced(GLsizei count, size_t level = 0);
   };
 }
 
@@ -0,0 +1,322 @@
+#include <cstring>
+#include <fstream>
+#include <sstream>
+#include <stdexcept>
+
+#include <glm/gtc/packing.hpp>
+
+#include "mesh_data.h"
+#include "tiny_obj_loader.h"
+
+namespace {
+  const char MESH_MAGIC[4] = {'P', 'M', 'S', 'H'};
+  const uint32_t MESH_VERSION = 3;
+  const uint64_t MESH_ALIGNMENT = 16;
+
+  struct Header {
+    char magic[4];
+    uint32_t version;
+    uint32_t shapeCount;
+    uint32_t levelCount;
+    float min[3];
+    float max[3];
+  };
+
+  struct ShapeHeader {
+    uint32_t vertexCount;
+    uint32_t indexCount;
+    uint64_t vertexOffset;
+    uint64_t indexOffset;
+    uint64_t levelOffset;
+    uint32_t levelCount;
+    uint32_t indexSize;
+    float min[3];
+    float max[3];
+  };
+
+  static_assert(sizeof(ppgso::PackedVertex) == 5 * sizeof(uint32_t), "PackedVertex must be tightly packed");
+  static_assert(sizeof(ppgso::MeshLevel) == 4 * sizeof(uint32_t), "MeshLevel must be tightly packed");
+
+  uint64_t align(uint64_t offset) {
+    return (offset + MESH_ALIGNMENT - 1) / MESH_ALIGNMENT * MESH_ALIGNMENT;
+  }
+
+  void computeBounds(ppgso::MeshShape &shape) {
+    if (shape.vertexCount == 0) return;
+    shape.min = shape.max = shape.vertices[0].position;
+    for (uint32_t i = 1; i < shape.vertexCount; i++) {
+      shape.min = glm::min(shape.min, shape.vertices[i].position);
+      shape.max = glm::max(shape.max, shape.vertices[i].position);
+    }
+  }
+
+  void computeBounds(ppgso::MeshData &data) {
+    bool first = true;
+    for (auto &shape : data.shapes) {
+      if (shape.vertexCount == 0) continue;
+      data.min = first ? shape.min : glm::min(data.min, shape.min);
+      data.max = first ? shape.max : glm::max(data.max, shape.max);
+      first = false;
+    }
+  }
+
+  void computeSphere(ppgso::MeshData &data) {
+    // Centering on the box is not the tightest sphere, but stable and good enough for culling
+    data.center = (data.min + data.max) * 0.5f;
+    float radius2 = 0;
+    for (auto &shape : data.shapes) {
+      for (uint32_t i = 0; i < shape.vertexCount; i++) {
+        auto offset = shape.vertices[i].position - data.center;
+        radius2 = glm::max(radius2, glm::dot(offset, offset));
+      }
+    }
+    data.radius = glm::sqrt(radius2);
+  }
+
+  [[noreturn]] void fail(const std::string &message, const std::string &file) {
+    std::stringstream msg;
+    msg << message << " " << file;
+    throw std::runtime_error(msg.str());
+  }
+}
+
+ppgso::PackedVertex ppgso::pack(const Vertex &vertex) {
+  auto length = glm::length(vertex.normal);
+  auto normal = length > 0 ? vertex.normal / length : vertex.normal;
+  return PackedVertex{vertex.position, glm::packHalf2x16(vertex.texCoord), glm::packSnorm3x10_1x2(glm::vec4(normal, 0))};
+}
+
+ppgso::Vertex ppgso::unpack(const PackedVertex &vertex) {
+  return Vertex{vertex.position, glm::unpackHalf2x16(vertex.texCoord), glm::vec3(glm::unpackSnorm3x10_1x2(vertex.normal))};
+}
+
+ppgso::MeshData ppgso::MeshData::load(const std::string &obj) {
+  auto mesh = binaryPath(obj);
+  if (MappedFile::exists(mesh))
+    return loadBinary(mesh);
+  return loadObj(obj);
+}
+
+std::string ppgso::MeshData::binaryPath(const std::string &obj) {
+  auto extension = obj.find_last_of('.');
+  auto separator = obj.find_last_of("/\\");
+  if (extension == std::string::npos || (separator != std::string::npos && extension < separator))
+    return obj + ".mesh";
+  return obj.substr(0, extension) + ".mesh";
+}
+
+ppgso::MeshData ppgso::MeshData::loadObj(const std::string &obj) {
+  std::vector<tinyobj::shape_t> shapes;
+  std::vector<tinyobj::material_t> materials;
+  std::string err = tinyobj::LoadObj(shapes, materials, obj.c_str());
+
+  if (!err.empty()) {
+    std::stringstream msg;
+    msg << err << std::endl << "Failed to load OBJ file " << obj << "!" << std::endl;
+    throw std::runtime_error(msg.str());
+  }
+
+  MeshData data;
+  for (auto &shape : shapes) {
+    auto &mesh = shape.mesh;
+    auto vertex_count = mesh.positions.size() / 3;
+    if (vertex_count == 0) continue;
+
+    // Interleave and compress positions, texture coordinates and normals, missing attributes are left zeroed
+    std::vector<PackedVertex> vertices(vertex_count);
+    for (size_t i = 0; i < vertex_count; i++) {
+      Vertex vertex{};
+      vertex.position = {mesh.positions[3 * i], mesh.positions[3 * i + 1], mesh.positions[3 * i + 2]};
+      if (mesh.texcoords.size() >= 2 * (i + 1))
+        vertex.texCoord = {mesh.texcoords[2 * i], mesh.texcoords[2 * i + 1]};
+      if (mesh.normals.size() >= 3 * (i + 1))
+        vertex.normal = {mesh.normals[3 * i], mesh.normals[3 * i + 1], mesh.normals[3 * i + 2]};
+      vertices[i] = pack(vertex);
+    }
+
+    // Meshes loaded from OBJ files only have their full detail
+    MeshShape view;
+    data.setVertices(view, std::move(vertices));
+    data.setIndices(view, mesh.indices);
+    data.setLevels(view, {MeshLevel{0, (uint32_t) mesh.indices.size(), 0, 0}});
+    computeBounds(view);
+    data.shapes.push_back(view);
+  }
+  computeBounds(data);
+  computeSphere(data);
+
+  return data;
+}
+
+ppgso::MeshData ppgso::MeshData::loadBinary(const std::string &mesh) {
+  MeshData data;
+  data.mapping = std::unique_ptr<MappedFile>(new MappedFile(mesh));
+
+  auto bytes = data.mapping->data();
+  auto size = data.mapping->size();
+
+  if (size < sizeof(Header))
+    fail("Mesh file is too small.", mesh);
+
+  Header header;
+  std::memcpy(&header, bytes, sizeof(Header));
+  if (std::memcmp(header.magic, MESH_MAGIC, sizeof(MESH_MAGIC)) != 0)
+    fail("Mesh file does not contain supported mesh format.", mesh);
+  if (header.version != MESH_VERSION)
+    fail("Mesh file has unsupported version.", mesh);
+  if (size < sizeof(Header) + header.shapeCount * sizeof(ShapeHeader))
+    fail("Mesh file is truncated.", mesh);
+
+  data.min = {header.min[0], header.min[1], header.min[2]};
+  data.max = {header.max[0], header.max[1], header.max[2]};
+
+  for (uint32_t i = 0; i < header.shapeCount; i++) {
+    ShapeHeader shape_header;
+    std::memcpy(&shape_header, bytes + sizeof(Header) + i * sizeof(ShapeHeader), sizeof(ShapeHeader));
+
+    if (shape_header.indexSize != sizeof(uint16_t) && shape_header.indexSize != sizeof(uint32_t))
+      fail("Mesh file has unsupported index size.", mesh);
+    if (shape_header.vertexOffset + shape_header.vertexCount * sizeof(PackedVertex) > size ||
+        shape_header.indexOffset + shape_header.indexCount * shape_header.indexSize > size ||
+        shape_header.levelOffset + shape_header.levelCount * sizeof(MeshLevel) > size)
+      fail("Mesh file is truncated.", mesh);
+    if (shape_header.levelCount == 0 || shape_header.levelCount != header.levelCount)
+      fail("Mesh file has inconsistent levels of detail.", mesh);
+
+    // Data blocks are aligned so the mapped memory can be used in place
+    MeshShape shape;
+    shape.vertices = reinterpret_cast<const PackedVertex *>(bytes + shape_header.vertexOffset);
+    shape.vertexCount = shape_header.vertexCount;
+    shape.indices = bytes + shape_header.indexOffset;
+    shape.indexCount = shape_header.indexCount;
+    shape.indexSize = shape_header.indexSize;
+    shape.levels = reinterpret_cast<const MeshLevel *>(bytes + shape_header.levelOffset);
+    shape.levelCount = shape_header.levelCount;
+    for (uint32_t l = 0; l < shape.levelCount; l++) {
+      if (shape.levels[l].firstIndex + (uint64_t) shape.levels[l].indexCount > shape.indexCount)
+        fail("Mesh file has level of detail outside of its indices.", mesh);
+    }
+    shape.min = {shape_header.min[0], shape_header.min[1], shape_header.min[2]};
+    shape.max = {shape_header.max[0], shape_header.max[1], shape_header.max[2]};
+    data.shapes.push_back(shape);
+  }
+  computeSphere(data);
+
+  return data;
+}
+
+void ppgso::MeshData::saveBinary(const std::string &mesh) const {
+  std::ofstream output(mesh, std::ios::binary);
+  if (!output.is_open())
+    fail("Could not open mesh file.", mesh);
+
+  Header header = {};
+  std::memcpy(header.magic, MESH_MAGIC, sizeof(MESH_MAGIC));
+  header.version = MESH_VERSION;
+  header.shapeCount = (uint32_t) shapes.size();
+  header.levelCount = levelCount();
+  for (int i = 0; i < 3; i++) {
+    header.min[i] = min[i];
+    header.max[i] = max[i];
+  }
+
+  // Lay out the data blocks after the headers
+  std::vector<ShapeHeader> shape_headers;
+  uint64_t offset = sizeof(Header) + shapes.size() * sizeof(ShapeHeader);
+  for (auto &shape : shapes) {
+    ShapeHeader shape_header = {};
+    shape_header.vertexCount = shape.vertexCount;
+    shape_header.indexCount = shape.indexCount;
+    shape_header.indexSize = shape.indexSize;
+    shape_header.vertexOffset = offset = align(offset);
+    offset += shape.vertexCount * sizeof(PackedVertex);
+    shape_header.indexOffset = offset = align(offset);
+    offset += shape.indexCount * shape.indexSize;
+    shape_header.levelCount = shape.levelCount;
+    shape_header.levelOffset = offset = align(offset);
+    offset += shape.levelCount * sizeof(MeshLevel);
+    for (int i = 0; i < 3; i++) {
+      shape_header.min[i] = shape.min[i];
+      shape_header.max[i] = shape.max[i];
+    }
+    shape_headers.push_back(shape_header);
+  }
+
+  output.write((const char *) &header, sizeof(Header));
+  output.write((const char *) shape_headers.data(), shape_headers.size() * sizeof(ShapeHeader));
+
+  const char padding[MESH_ALIGNMENT] = {};
+  uint64_t written = sizeof(Header) + shape_headers.size() * sizeof(ShapeHeader);
+  for (size_t i = 0; i < shapes.size(); i++) {
+    output.write(padding, shape_headers[i].vertexOffset - written);
+    output.write((const char *) shapes[i].vertices, shapes[i].vertexCount * sizeof(PackedVertex));
+    written = shape_headers[i].vertexOffset + shapes[i].vertexCount * sizeof(PackedVertex);
+
+    output.write(padding, shape_headers[i].indexOffset - written);
+    output.write((const char *) shapes[i].indices, shapes[i].indexCount * shapes[i].indexSize);
+    written = shape_headers[i].indexOffset + shapes[i].indexCount * shapes[i].indexSize;
+
+    output.write(padding, shape_headers[i].levelOffset - written);
+    output.write((const char *) shapes[i].levels, shapes[i].levelCount * sizeof(MeshLevel));
+    written = shape_headers[i].levelOffset + shapes[i].levelCount * sizeof(MeshLevel);
+  }
+
+  if (!output)
+    fail("Failed to write mesh file.", mesh);
+}
+
+void ppgso::MeshData::addShape(std::vector<PackedVertex> vertices, const std::vector<uint32_t> &indices) {
+  MeshShape view;
+  setVertices(view, std::move(vertices));
+  setIndices(view, indices);
+  setLevels(view, {MeshLevel{0, (uint32_t) indices.size(), 0, 0}});
+  computeBounds(view);
+  shapes.push_back(view);
+  computeBounds(*this);
+  computeSphere(*this);
+}
+
+uint32_t ppgso::MeshData::levelCount() const {
+  uint32_t levels = 1;
+  for (auto &shape : shapes)
+    levels = glm::max(levels, shape.levelCount);
+  return levels;
+}
+
+float ppgso::MeshData::levelError(uint32_t level) const {
+  float error = 0;
+  for (auto &shape : shapes) {
+    if (level < shape.levelCount)
+      error = glm::max(error, shape.levels[level].error);
+  }
+  return error;
+}
+
+void ppgso::MeshData::setVertices(MeshShape &shape, std::vector<PackedVertex> vertices) {
+  vertexStorage.push_back(std::move(vertices));
+  shape.vertices = vertexStorage.back().data();
+  shape.vertexCount = (uint32_t) vertexStorage.back().size();
+}
+
+void ppgso::MeshData::setIndices(MeshShape &shape, const std::vector<uint32_t> &indices) {
+  // Half the index data when every vertex can be addressed with 16 bits
+  shape.indexSize = shape.vertexCount <= 0x10000 ? sizeof(uint16_t) : sizeof(uint32_t);
+  indexStorage.emplace_back(indices.size() * shape.indexSize);
+  auto storage = indexStorage.back().data();
+  if (shape.indexSize == sizeof(uint16_t)) {
+    for (size_t i = 0; i < indices.size(); i++) {
+      auto index = (uint16_t) indices[i];
+      std::memcpy(storage + i * sizeof(uint16_t), &index, sizeof(uint16_t));
+    }
+  } else {
+    std::memcpy(storage, indices.data(), indices.size() * sizeof(uint32_t));
+  }
+  shape.indices = storage;
+  shape.indexCount = (uint32_t) indices.size();
+}
+
+void ppgso::MeshData::setLevels(MeshShape &shape, std::vector<MeshLevel> levels) {
+  levelStorage.push_back(std::move(levels));
+  shape.levels = levelStorage.back().data();
+  shape.levelCount = (uint32_t) levelStorage.back().size();
+}
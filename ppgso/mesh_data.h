@@ -0,0 +1,215 @@
+#pragma once
+#include <string>
+#include <vector>
+#include <memory>
+#include <cstdint>
+
+#include <glm/glm.hpp>
+
+#include "mapped_file.h"
+
+namespace ppgso {
+
+  /*!
+   * Vertex with full precision attributes, as parsed from an obj file.
+   */
+  struct Vertex {
+    glm::vec3 position;
+    glm::vec2 texCoord;
+    glm::vec3 normal;
+  };
+
+  /*!
+   * Compressed interleaved vertex layout used for all mesh vertex buffers, 20 bytes instead of 32.
+   * vec3 Position - position 0, 32 bit floats
+   * vec2 TexCoord - position 1, 16 bit floats
+   * vec3 Normal - position 2, signed normalized 10:10:10:2 integer
+   */
+  struct PackedVertex {
+    glm::vec3 position;
+    uint32_t texCoord;
+    uint32_t normal;
+  };
+
+  /*!
+   * Compress a vertex into the layout of the vertex buffers.
+   *
+   * @param vertex - Vertex to compress, the normal is normalized on the way.
+   * @return - Compressed vertex.
+   */
+  PackedVertex pack(const Vertex &vertex);
+
+  /*!
+   * Expand a compressed vertex.
+   *
+   * @param vertex - Vertex to expand.
+   * @return - Vertex with the precision left after compression.
+   */
+  Vertex unpack(const PackedVertex &vertex);
+
+  /*!
+   * Range of the index block of a shape drawn for one level of detail.
+   * Error is the largest distance the level deviates from the full detail geometry, in model space.
+   */
+  struct MeshLevel {
+    uint32_t firstIndex;
+    uint32_t indexCount;
+    float error;
+    uint32_t reserved;
+  };
+
+  /*!
+   * View of one shape of the mesh in upload ready layout.
+   * The pointers are owned by the MeshData the shape belongs to.
+   * The index block holds the indices of all levels of detail, all levels share the vertices.
+   */
+  struct MeshShape {
+    const PackedVertex *vertices = nullptr;
+    uint32_t vertexCount = 0;
+    // 16 bit indices when the shape has few enough vertices, 32 bit otherwise
+    const void *indices = nullptr;
+    uint32_t indexCount = 0;
+    uint32_t indexSize = sizeof(uint32_t);
+    const MeshLevel *levels = nullptr;
+    uint32_t levelCount = 0;
+    glm::vec3 min{0, 0, 0};
+    glm::vec3 max{0, 0, 0};
+
+    /*!
+     * Read an index regardless of its size.
+     *
+     * @param i - Position in the index block.
+     * @return - Index of the vertex.
+     */
+    uint32_t index(uint32_t i) const {
+      if (indexSize == sizeof(uint16_t))
+        return static_cast<const uint16_t *>(indices)[i];
+      return static_cast<const uint32_t *>(indices)[i];
+    }
+  };
+
+  /*!
+   * CPU side geometry of a mesh, either parsed from a Wavefront .obj file or mapped from a precompiled binary .mesh file.
+   *
+   * Binary .mesh layout (little endian, all blocks 16 byte aligned):
+   * Header - magic "PMSH", version, shape count, level count, bounds of the whole mesh
+   * ShapeHeader[shape count] - vertex/index counts, offsets of the data blocks from file start and bounds of the shape
+   * PackedVertex[vertex count], uint16_t or uint32_t[index count], MeshLevel[level count] - data blocks of each shape
+   */
+  class MeshData {
+  public:
+    MeshData() = default;
+    MeshData(MeshData&&) = default;
+    MeshData &operator=(MeshData&&) = default;
+    MeshData(const MeshData&) = delete;
+    MeshData &operator=(const MeshData&) = delete;
+
+    /*!
+     * Load geometry, the precompiled binary file next to the obj file is preferred when it exists.
+     *
+     * @param obj - File path to the obj file.
+     * @return - Loaded geometry.
+     */
+    static MeshData load(const std::string &obj);
+
+    /*!
+     * Parse geometry from a Wavefront .obj file.
+     *
+     * @param obj - File path to the obj file.
+     * @return - Loaded geometry.
+     */
+    static MeshData loadObj(const std::string &obj);
+
+    /*!
+     * Memory map geometry from a precompiled binary .mesh file, no copies of the vertex data are made.
+     *
+     * @param mesh - File path to the mesh file.
+     * @return - Loaded geometry.
+     */
+    static MeshData loadBinary(const std::string &mesh);
+
+    /*!
+     * Save geometry as a precompiled binary .mesh file.
+     *
+     * @param mesh - File path of the mesh file to write.
+     */
+    void saveBinary(const std::string &mesh) const;
+
+    /*!
+     * Replace the levels of detail of every shape with simplified versions of the full detail geometry.
+     * Triangles are removed by collapsing edges in the order of their quadric error, vertices are kept
+     * so all levels share one vertex buffer. Vertices on texture or normal seams and on open borders stay in place.
+     *
+     * @param levels - Number of levels including the full detail one.
+     * @param ratio - Part of the triangles of the previous level kept by each level.
+     */
+    void generateLevels(uint32_t levels, float ratio = 0.5f);
+
+    /*!
+     * Reorder the geometry of every shape for the GPU, meant to run once when the mesh is compiled.
+     * Vertices that compressed to the same values are merged, the triangles of every level of detail are
+     * reordered for the post transform vertex cache and the vertices are sorted in the order they are first used.
+     */
+    void optimize();
+
+    /*!
+     * Add a shape built in memory, it only has its full detail. The bounds of the mesh are updated.
+     *
+     * @param vertices - Vertices of the shape.
+     * @param indices - Triangle list indexing the vertices.
+     */
+    void addShape(std::vector<PackedVertex> vertices, const std::vector<uint32_t> &indices);
+
+    /*!
+     * Get number of levels of detail, all shapes have the same number.
+     *
+     * @return - Number of levels, 1 when the mesh has only its full detail.
+     */
+    uint32_t levelCount() const;
+
+    /*!
+     * Get the error of a level of detail over all shapes.
+     *
+     * @param level - Level of detail, 0 is the full detail.
+     * @return - Largest deviation from the full detail geometry in model space.
+     */
+    float levelError(uint32_t level) const;
+
+    /*!
+     * Get path of the precompiled binary file that belongs to an obj file.
+     *
+     * @param obj - File path to the obj file.
+     * @return - Same path with the .mesh extension.
+     */
+    static std::string binaryPath(const std::string &obj);
+
+    std::vector<MeshShape> shapes;
+    glm::vec3 min{0, 0, 0};
+    glm::vec3 max{0, 0, 0};
+
+    // Bounding sphere around the center of the bounding box, computed on load
+    glm::vec3 center{0, 0, 0};
+    float radius = 0;
+
+  private:
+    /*!
+     * Replace the vertices of a shape with owned ones.
+     */
+    void setVertices(MeshShape &shape, std::vector<PackedVertex> vertices);
+
+    /*!
+     * Replace the indices of a shape with owned ones, stored as 16 bit when the vertex count allows.
+     */
+    void setIndices(MeshShape &shape, const std::vector<uint32_t> &indices);
+
+    /*!
+     * Replace the levels of detail of a shape with owned ones.
+     */
+    void setLevels(MeshShape &shape, std::vector<MeshLevel> levels);
+
+    std::vector<std::vector<PackedVertex>> vertexStorage;
+    std::vector<std::vector<uint8_t>> indexStorage;
+    std::vector<std::vector<MeshLevel>> levelStorage;
+    std::unique_ptr<MappedFile> mapping;
+  };
+}
@@ -0,0 +1,159 @@
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <functional>
+#include <map>
+
+#include "mesh_data.h"
+
+namespace {
+  // Vertex cache modeled by the triangle ordering, larger than most real caches so it holds up across GPUs
+  const int CACHE_SIZE = 32;
+  const float CACHE_DECAY_POWER = 1.5f;
+  const float LAST_TRIANGLE_SCORE = 0.75f;
+  const float VALENCE_BOOST_SCALE = 2.0f;
+  const float VALENCE_BOOST_POWER = 0.5f;
+
+  /*!
+   * Score of a vertex after Forsyth, high when it is in the cache or has few triangles left.
+   */
+  float vertexScore(int cachePosition, uint32_t remaining) {
+    if (remaining == 0) return -1;
+
+    float score = 0;
+    if (cachePosition >= 3) {
+      // Vertices leaving the cache soon are worth less than the ones just used
+      auto scaler = 1.0f / (CACHE_SIZE - 3);
+      score = std::pow(1.0f - (cachePosition - 3) * scaler, CACHE_DECAY_POWER);
+    } else if (cachePosition >= 0) {
+      // The vertices of the last triangle get a fixed score so the next triangle does not just reuse them
+      score = LAST_TRIANGLE_SCORE;
+    }
+
+    // Finish off vertices with few triangles left so they do not linger
+    return score + VALENCE_BOOST_SCALE * std::pow((float) remaining, -VALENCE_BOOST_POWER);
+  }
+
+  /*!
+   * Reorder the triangles of an index list for the post transform vertex cache with Forsyth's greedy algorithm.
+   */
+  std::vector<uint32_t> reorderTriangles(const std::vector<uint32_t> &indices, uint32_t vertexCount) {
+    auto triangle_count = indices.size() / 3;
+
+    // Triangles of every vertex, the ones still to emit are kept at the front of each range
+    std::vector<uint32_t> remaining(vertexCount, 0), first(vertexCount + 1, 0);
+    for (auto index : indices)
+      remaining[index]++;
+    for (uint32_t v = 0; v < vertexCount; v++)
+      first[v + 1] = first[v] + remaining[v];
+    std::vector<uint32_t> triangles(indices.size()), filled(first.begin(), first.end() - 1);
+    for (size_t i = 0; i < indices.size(); i++)
+      triangles[filled[indices[i]]++] = (uint32_t) (i / 3);
+
+    std::vector<int> cache_positions(vertexCount, -1);
+    std::vector<float> vertex_scores(vertexCount);
+    for (uint32_t v = 0; v < vertexCount; v++)
+      vertex_scores[v] = vertexScore(-1, remaining[v]);
+
+    std::vector<bool> emitted(triangle_count, false);
+
+    std::vector<uint32_t> result;
+    result.reserve(indices.size());
+    std::vector<uint32_t> cache, next_cache;
+    size_t cursor = 0;
+    auto best = triangle_count;
+
+    while (result.size() < indices.size()) {
+      // Without a candidate next to the cache continue with the next triangle not emitted yet
+      if (best == triangle_count) {
+        while (emitted[cursor]) cursor++;
+        best = cursor;
+      }
+
+      emitted[best] = true;
+      next_cache.clear();
+      for (int i = 0; i < 3; i++) {
+        auto v = indices[3 * best + i];
+        result.push_back(v);
+        next_cache.push_back(v);
+
+        // Move the triangle out of the front of the range of the vertex
+        auto begin = triangles.begin() + first[v], end = begin + remaining[v];
+        std::iter_swap(std::find(begin, end, (uint32_t) best), end - 1);
+        remaining[v]--;
+      }
+      for (auto v : cache) {
+        if (std::find(next_cache.begin(), next_cache.end(), v) == next_cache.end())
+          next_cache.push_back(v);
+      }
+
+      // Rescore the vertices in the cache and the ones just pushed out of it
+      for (size_t i = 0; i < next_cache.size(); i++) {
+        auto v = next_cache[i];
+        cache_positions[v] = i < (size_t) CACHE_SIZE ? (int) i : -1;
+        vertex_scores[v] = vertexScore(cache_positions[v], remaining[v]);
+      }
+      if (next_cache.size() > (size_t) CACHE_SIZE)
+        next_cache.resize(CACHE_SIZE);
+      std::swap(cache, next_cache);
+
+      // Pick the best triangle around the cache for the next step
+      best = triangle_count;
+      float best_score = -1;
+      for (auto v : cache) {
+        for (uint32_t i = 0; i < remaining[v]; i++) {
+          auto t = triangles[first[v] + i];
+          auto score = vertex_scores[indices[3 * t]] + vertex_scores[indices[3 * t + 1]] + vertex_scores[indices[3 * t + 2]];
+          if (score > best_score) {
+            best_score = score;
+            best = t;
+          }
+        }
+      }
+    }
+    return result;
+  }
+}
+
+void ppgso::MeshData::optimize() {
+  for (auto &shape : shapes) {
+    // Vertices that only differed in the precision lost by compression are now identical
+    auto less = [&shape](uint32_t a, uint32_t b) {
+      return std::memcmp(&shape.vertices[a], &shape.vertices[b], sizeof(PackedVertex)) < 0;
+    };
+    std::map<uint32_t, uint32_t, std::function<bool(uint32_t, uint32_t)>> unique(less);
+    std::vector<uint32_t> welded(shape.vertexCount);
+    for (uint32_t v = 0; v < shape.vertexCount; v++)
+      welded[v] = unique.emplace(v, v).first->second;
+
+    // Levels sharing the indices of the level before them are reordered once
+    std::vector<MeshLevel> levels(shape.levels, shape.levels + shape.levelCount);
+    std::vector<uint32_t> indices(shape.indexCount);
+    for (uint32_t i = 0; i < shape.indexCount; i++)
+      indices[i] = welded[shape.index(i)];
+    for (size_t l = 0; l < levels.size(); l++) {
+      if (l > 0 && levels[l].firstIndex == levels[l - 1].firstIndex) continue;
+      std::vector<uint32_t> range(indices.begin() + levels[l].firstIndex,
+                                  indices.begin() + levels[l].firstIndex + levels[l].indexCount);
+      auto reordered = reorderTriangles(range, shape.vertexCount);
+      std::copy(reordered.begin(), reordered.end(), indices.begin() + levels[l].firstIndex);
+    }
+
+    // Number vertices in the order the full detail fetches them, vertices only coarser levels use come after
+    const uint32_t UNUSED = 0xFFFFFFFF;
+    std::vector<uint32_t> order(shape.vertexCount, UNUSED);
+    std::vector<PackedVertex> vertices;
+    for (auto &index : indices) {
+      if (order[index] == UNUSED) {
+        order[index] = (uint32_t) vertices.size();
+        vertices.push_back(shape.vertices[index]);
+      }
+      index = order[index];
+    }
+
+    // Bounds stay as they are, unused vertices only ever made them larger
+    setVertices(shape, std::move(vertices));
+    setIndices(shape, indices);
+    setLevels(shape, std::move(levels));
+  }
+}
@@ -0,0 +1,334 @@
+#include <algorithm>
+#include <cstring>
+#include <functional>
+#include <map>
+#include <queue>
+#include <utility>
+
+#include "mesh_data.h"
+
+namespace {
+  // Collapses that would turn a face further than this, as cosine between the normals, are rejected
+  const double MAX_NORMAL_CHANGE = 0.2;
+
+  /*!
+   * Symmetric 4x4 matrix that sums the squared distances of a point to a set of planes.
+   */
+  struct Quadric {
+    double a2 = 0, ab = 0, ac = 0, ad = 0, b2 = 0, bc = 0, bd = 0, c2 = 0, cd = 0, d2 = 0;
+
+    void addPlane(const glm::dvec3 &normal, double d) {
+      a2 += normal.x * normal.x; ab += normal.x * normal.y; ac += normal.x * normal.z; ad += normal.x * d;
+      b2 += normal.y * normal.y; bc += normal.y * normal.z; bd += normal.y * d;
+      c2 += normal.z * normal.z; cd += normal.z * d;
+      d2 += d * d;
+    }
+
+    void add(const Quadric &other) {
+      a2 += other.a2; ab += other.ab; ac += other.ac; ad += other.ad;
+      b2 += other.b2; bc += other.bc; bd += other.bd;
+      c2 += other.c2; cd += other.cd;
+      d2 += other.d2;
+    }
+
+    double error(const glm::dvec3 &p) const {
+      auto value = a2 * p.x * p.x + 2 * ab * p.x * p.y + 2 * ac * p.x * p.z + 2 * ad * p.x
+                   + b2 * p.y * p.y + 2 * bc * p.y * p.z + 2 * bd * p.y
+                   + c2 * p.z * p.z + 2 * cd * p.z
+                   + d2;
+      return glm::max(value, 0.0);
+    }
+  };
+
+  /*!
+   * Candidate move of one vertex onto a neighbour, outdated once either of them changed.
+   */
+  struct Collapse {
+    double cost;
+    uint32_t from, to;
+    uint32_t fromVersion, toVersion;
+
+    bool operator>(const Collapse &other) const {
+      return cost > other.cost;
+    }
+  };
+
+  /*!
+   * Quadric error metric simplification by half edge collapses, vertices only ever move onto existing
+   * vertices so every intermediate result indexes the original vertex buffer.
+   */
+  class Simplifier {
+  public:
+    Simplifier(const ppgso::PackedVertex *vertices, uint32_t vertexCount, const uint32_t *indices, uint32_t indexCount)
+            : vertices{vertices}, remap(vertexCount), locked(vertexCount, false), removed(vertexCount, false),
+              versions(vertexCount, 0), quadrics(vertexCount), adjacent(vertexCount) {
+      weld();
+
+      for (uint32_t i = 0; i + 2 < indexCount; i += 3) {
+        Triangle triangle{{remap[indices[i]], remap[indices[i + 1]], remap[indices[i + 2]]}};
+        if (triangle.v[0] == triangle.v[1] || triangle.v[1] == triangle.v[2] || triangle.v[0] == triangle.v[2])
+          continue;
+        for (auto v : triangle.v)
+          adjacent[v].push_back((uint32_t) triangles.size());
+        triangles.push_back(triangle);
+      }
+      alive.assign(triangles.size(), true);
+      liveTriangles = triangles.size();
+
+      lockSeamsAndBorders();
+
+      // Every vertex starts with the planes of the faces around it
+      for (auto &triangle : triangles) {
+        auto p0 = position(triangle.v[0]), p1 = position(triangle.v[1]), p2 = position(triangle.v[2]);
+        auto normal = glm::cross(p1 - p0, p2 - p0);
+        auto length = glm::length(normal);
+        if (length <= 0) continue;
+        normal /= length;
+        for (auto v : triangle.v)
+          quadrics[v].addPlane(normal, -glm::dot(normal, p0));
+      }
+
+      for (uint32_t v = 0; v < remap.size(); v++) {
+        if (remap[v] != v || locked[v]) continue;
+        for (auto other : neighbours(v))
+          push(v, other);
+      }
+    }
+
+    /*!
+     * Collapse the cheapest edges until at most the target number of triangles is left or nothing can collapse.
+     */
+    void reduce(size_t targetTriangles) {
+      while (liveTriangles > targetTriangles && !queue.empty()) {
+        auto collapse = queue.top();
+        queue.pop();
+        if (removed[collapse.from] || removed[collapse.to] ||
+            versions[collapse.from] != collapse.fromVersion || versions[collapse.to] != collapse.toVersion)
+          continue;
+        if (!canCollapse(collapse.from, collapse.to))
+          continue;
+        apply(collapse);
+      }
+    }
+
+    std::vector<uint32_t> indices() const {
+      std::vector<uint32_t> result;
+      result.reserve(liveTriangles * 3);
+      for (size_t t = 0; t < triangles.size(); t++) {
+        if (!alive[t]) continue;
+        result.insert(result.end(), triangles[t].v, triangles[t].v + 3);
+      }
+      return result;
+    }
+
+    /*!
+     * Largest distance a collapsed vertex was moved away from its planes so far.
+     */
+    float error() const {
+      return (float) glm::sqrt(maxCost);
+    }
+
+  private:
+    struct Triangle {
+      uint32_t v[3];
+
+      bool contains(uint32_t vertex) const {
+        return v[0] == vertex || v[1] == vertex || v[2] == vertex;
+      }
+    };
+
+    glm::dvec3 position(uint32_t v) const {
+      return glm::dvec3(vertices[v].position);
+    }
+
+    /*!
+     * Merge vertices with identical attributes, OBJ files often repeat them per face.
+     */
+    void weld() {
+      auto less = [this](uint32_t a, uint32_t b) {
+        return std::memcmp(&vertices[a], &vertices[b], sizeof(ppgso::PackedVertex)) < 0;
+      };
+      std::map<uint32_t, uint32_t, std::function<bool(uint32_t, uint32_t)>> unique(less);
+      for (uint32_t v = 0; v < remap.size(); v++) {
+        remap[v] = unique.emplace(v, v).first->second;
+        if (remap[v] != v) removed[v] = true;
+      }
+    }
+
+    /*!
+     * Lock vertices whose position is shared by differing vertices, and vertices of open or non manifold edges.
+     * Moving them would tear the seams or shrink the outline of the mesh.
+     */
+    void lockSeamsAndBorders() {
+      auto less = [this](uint32_t a, uint32_t b) {
+        auto &pa = vertices[a].position, &pb = vertices[b].position;
+        if (pa.x != pb.x) return pa.x < pb.x;
+        if (pa.y != pb.y) return pa.y < pb.y;
+        return pa.z < pb.z;
+      };
+      std::map<uint32_t, std::vector<uint32_t>, std::function<bool(uint32_t, uint32_t)>> corners(less);
+      for (uint32_t v = 0; v < remap.size(); v++) {
+        if (remap[v] == v)
+          corners[v].push_back(v);
+      }
+
+      std::vector<uint32_t> positionIds(remap.size());
+      uint32_t id = 0;
+      for (auto &corner : corners) {
+        for (auto v : corner.second) {
+          positionIds[v] = id;
+          if (corner.second.size() > 1) locked[v] = true;
+        }
+        id++;
+      }
+
+      // Edges are counted by position so seams do not count as borders
+      std::map<std::pair<uint32_t, uint32_t>, int> edges;
+      for (auto &triangle : triangles) {
+        for (int e = 0; e < 3; e++) {
+          auto a = positionIds[triangle.v[e]], b = positionIds[triangle.v[(e + 1) % 3]];
+          edges[{glm::min(a, b), glm::max(a, b)}]++;
+        }
+      }
+      std::vector<bool> lockedIds(id, false);
+      for (auto &edge : edges) {
+        if (edge.second != 2)
+          lockedIds[edge.first.first] = lockedIds[edge.first.second] = true;
+      }
+      for (uint32_t v = 0; v < remap.size(); v++) {
+        if (remap[v] == v && lockedIds[positionIds[v]])
+          locked[v] = true;
+      }
+    }
+
+    std::vector<uint32_t> neighbours(uint32_t v) const {
+      std::vector<uint32_t> result;
+      for (auto t : adjacent[v]) {
+        if (!alive[t]) continue;
+        for (auto other : triangles[t].v) {
+          if (other != v) result.push_back(other);
+        }
+      }
+      std::sort(result.begin(), result.end());
+      result.erase(std::unique(result.begin(), result.end()), result.end());
+      return result;
+    }
+
+    void pushCollapses(uint32_t v) {
+      for (auto other : neighbours(v)) {
+        if (!locked[v]) push(v, other);
+        if (!locked[other]) push(other, v);
+      }
+    }
+
+    void push(uint32_t from, uint32_t to) {
+      Quadric quadric = quadrics[from];
+      quadric.add(quadrics[to]);
+      queue.push(Collapse{quadric.error(position(to)), from, to, versions[from], versions[to]});
+    }
+
+    /*!
+     * Check the collapse keeps the surface manifold and does not fold any face over.
+     */
+    bool canCollapse(uint32_t from, uint32_t to) const {
+      // The only vertices both ends share must be the ones across the faces being removed
+      int shared = 0;
+      for (auto t : adjacent[from]) {
+        if (alive[t] && triangles[t].contains(to)) shared++;
+      }
+      if (shared == 0) return false;
+      auto fromNeighbours = neighbours(from), toNeighbours = neighbours(to);
+      std::vector<uint32_t> common;
+      std::set_intersection(fromNeighbours.begin(), fromNeighbours.end(), toNeighbours.begin(), toNeighbours.end(),
+                            std::back_inserter(common));
+      if ((int) common.size() != shared) return false;
+
+      auto target = position(to);
+      for (auto t : adjacent[from]) {
+        if (!alive[t] || triangles[t].contains(to)) continue;
+        glm::dvec3 before[3], after[3];
+        for (int i = 0; i < 3; i++) {
+          auto v = triangles[t].v[i];
+          before[i] = position(v);
+          after[i] = v == from ? target : before[i];
+        }
+        auto oldNormal = glm::cross(before[1] - before[0], before[2] - before[0]);
+        auto newNormal = glm::cross(after[1] - after[0], after[2] - after[0]);
+        auto oldLength = glm::length(oldNormal), newLength = glm::length(newNormal);
+        if (newLength <= 0) return false;
+        if (oldLength > 0 && glm::dot(oldNormal, newNormal) < MAX_NORMAL_CHANGE * oldLength * newLength)
+          return false;
+      }
+      return true;
+    }
+
+    void apply(const Collapse &collapse) {
+      auto from = collapse.from, to = collapse.to;
+      for (auto t : adjacent[from]) {
+        if (!alive[t]) continue;
+        auto &triangle = triangles[t];
+        if (triangle.contains(to)) {
+          alive[t] = false;
+          liveTriangles--;
+          continue;
+        }
+        for (auto &v : triangle.v) {
+          if (v == from) v = to;
+        }
+        adjacent[to].push_back(t);
+      }
+      adjacent[from].clear();
+      adjacent[to].erase(std::remove_if(adjacent[to].begin(), adjacent[to].end(), [this](uint32_t t) { return !alive[t]; }),
+                         adjacent[to].end());
+
+      quadrics[to].add(quadrics[from]);
+      removed[from] = true;
+      versions[to]++;
+      maxCost = glm::max(maxCost, collapse.cost);
+      pushCollapses(to);
+    }
+
+    const ppgso::PackedVertex *vertices;
+    std::vector<uint32_t> remap;
+    std::vector<bool> locked, removed;
+    std::vector<uint32_t> versions;
+    std::vector<Quadric> quadrics;
+    std::vector<std::vector<uint32_t>> adjacent;
+    std::vector<Triangle> triangles;
+    std::vector<bool> alive;
+    size_t liveTriangles = 0;
+    double maxCost = 0;
+    std::priority_queue<Collapse, std::vector<Collapse>, std::greater<Collapse>> queue;
+  };
+}
+
+void ppgso::MeshData::generateLevels(uint32_t levels, float ratio) {
+  for (auto &shape : shapes) {
+    // Always simplify the full detail, earlier generated levels are replaced
+    auto full = shape.levelCount > 0 ? shape.levels[0] : MeshLevel{0, shape.indexCount, 0, 0};
+    std::vector<uint32_t> indices(full.indexCount);
+    for (uint32_t i = 0; i < full.indexCount; i++)
+      indices[i] = shape.index(full.firstIndex + i);
+    std::vector<MeshLevel> shape_levels = {MeshLevel{0, full.indexCount, 0, 0}};
+
+    Simplifier simplifier(shape.vertices, shape.vertexCount, indices.data(), full.indexCount);
+    double target = full.indexCount / 3;
+    for (uint32_t level = 1; level < levels; level++) {
+      target *= ratio;
+      simplifier.reduce((size_t) target);
+      auto level_indices = simplifier.indices();
+
+      // Levels the simplifier could not reduce any further share the indices of the previous one
+      auto previous = shape_levels.back();
+      if (level_indices.size() == previous.indexCount) {
+        shape_levels.push_back(MeshLevel{previous.firstIndex, previous.indexCount, simplifier.error(), 0});
+        continue;
+      }
+      shape_levels.push_back(MeshLevel{(uint32_t) indices.size(), (uint32_t) level_indices.size(), simplifier.error(), 0});
+      indices.insert(indices.end(), level_indices.begin(), level_indices.end());
+    }
+
+    setIndices(shape, indices);
+    setLevels(shape, std::move(shape_levels));
+  }
+}
@@ -4,8 +4,11 @@
 #include <glm/gtc/random.hpp>
 #include <glm/gtx/compatibility.hpp>
 
+#include "mapped_file.h"
+#include "mesh_data.h"
 #include "mesh.h"
 #include "shader.h"
+#include "uniform_buffer.h"
 #include "image.h"
 #include "image_bmp.h"
 #include "image_raw.h"
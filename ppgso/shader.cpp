@@ -74,15 +74,55 @@ ppgso::Shader::Shader(const std::string &vertex_shader_code, const std::string &
   glDeleteShader(fragment_shader_id);
 
   program = program_id;
+  reflectUniforms();
   use();
 }
 
+namespace {
+  // Program currently bound with glUseProgram, used to skip redundant binds
+  GLuint current_program = 0;
+}
+
+void ppgso::Shader::reflectUniforms() {
+  GLint count = 0, max_length = 0;
+  glGetProgramiv(program, GL_ACTIVE_UNIFORMS, &count);
+  glGetProgramiv(program, GL_ACTIVE_UNIFORM_MAX_LENGTH, &max_length);
+
+  std::string name((size_t) max_length, '\0');
+  for (GLint i = 0; i < count; i++) {
+    GLsizei length = 0;
+    GLint size = 0;
+    GLenum type = 0;
+    glGetActiveUniform(program, (GLuint) i, max_length, &length, &size, &type, &name[0]);
+    auto uniform_name = name.substr(0, (size_t) length);
+
+    // Uniforms in blocks have no location
+    auto location = glGetUniformLocation(program, uniform_name.c_str());
+    if (location < 0) continue;
+    uniforms[uniform_name] = location;
+
+    // Arrays of basic types are reported once as "name[0]", register the plain name and every element
+    auto suffix = uniform_name.rfind("[0]");
+    if (suffix != std::string::npos && suffix + 3 == uniform_name.size()) {
+      auto base = uniform_name.substr(0, suffix);
+      uniforms[base] = location;
+      for (GLint element = 1; element < size; element++) {
+        auto element_name = base + "[" + std::to_string(element) + "]";
+        uniforms[element_name] = glGetUniformLocation(program, element_name.c_str());
+      }
+    }
+  }
+}
+
 ppgso::Shader::~Shader() {
+  if (current_program == program) current_program = 0;
   glDeleteProgram( program );
 }
 
 void ppgso::Shader::use() const {
+  if (current_program == program) return;
   glUseProgram(program);
+  current_program = program;
 }
 
 GLuint ppgso::Shader::getAttribLocation(const std::string &name) const {
@@ -90,34 +130,33 @@ GLuint ppgso::Shader::getAttribLocation(const std::string &name) const {
   return (GLuint) glGetAttribLocation(program, name.c_str());
 }
 
-GLuint ppgso::Shader::getUniformLocation(const std::string &name) const {
+GLint ppgso::Shader::getUniformLocation(const std::string &name) const {
   use();
-  return (GLuint) glGetUniformLocation(program, name.c_str());
+  auto uniform = uniforms.find(name);
+  if (uniform == uniforms.end()) return -1;
+  return uniform->second;
+}
+
+void ppgso::Shader::bindUniformBlock(const std::string &name, GLuint binding) const {
+  auto index = glGetUniformBlockIndex(program, name.c_str());
+  if (index == GL_INVALID_INDEX) return;
+  glUniformBlockBinding(program, index, binding);
 }
 
 void ppgso::Shader::setUniform(const std::string &name, const Texture &texture, const int id) const {
-  use();
-  auto uniform = getUniformLocation(name.c_str());
-  glUniform1i(uniform, id);
-  texture.bind(id);
+  setUniform(uniform<Texture>(name), texture, id);
 }
 
 void ppgso::Shader::setUniform(const std::string &name, glm::mat4 matrix) const {
-  use();
-  auto uniform = getUniformLocation(name.c_str());
-  glUniformMatrix4fv(uniform, 1, GL_FALSE, value_ptr(matrix));
+  setUniform(uniform<glm::mat4>(name), matrix);
 }
 
 void ppgso::Shader::setUniform(const std::string &name, glm::mat3 matrix) const {
-  use();
-  auto uniform = getUniformLocation(name.c_str());
-  glUniformMatrix3fv(uniform, 1, GL_FALSE, value_ptr(matrix));
+  setUniform(uniform<glm::mat3>(name), matrix);
 }
 
 void ppgso::Shader::setUniform(const std::string &name, float value) const {
-  use();
-  auto uniform = getUniformLocation(name.c_str());
-  glUniform1f(uniform, value);
+  setUniform(uniform<float>(name), value);
 }
 
 GLuint ppgso::Shader::getProgram() const {
@@ -125,19 +164,49 @@ GLuint ppgso::Shader::getProgram() const {
 }
 
 void ppgso::Shader::setUniform(const std::string &name, glm::vec2 vector) const {
-  use();
-  auto uniform = getUniformLocation(name.c_str());
-  glUniform2fv(uniform, 1, value_ptr(vector));
+  setUniform(uniform<glm::vec2>(name), vector);
 }
 
 void ppgso::Shader::setUniform(const std::string &name, glm::vec3 vector) const {
-  use();
-  auto uniform = getUniformLocation(name.c_str());
-  glUniform3fv(uniform, 1, value_ptr(vector));
+  setUniform(uniform<glm::vec3>(name), vector);
 }
 
 void ppgso::Shader::setUniform(const std::string &name, glm::vec4 vector) const {
+  setUniform(uniform<glm::vec4>(name), vector);
+}
+
+void ppgso::Shader::setUniform(Uniform<Texture> uniform, const Texture &texture, const int id) const {
+  use();
+  glUniform1i(uniform.location, id);
+  texture.bind(id);
+}
+
+void ppgso::Shader::setUniform(Uniform<glm::mat4> uniform, const glm::mat4 &matrix) const {
+  use();
+  glUniformMatrix4fv(uniform.location, 1, GL_FALSE, value_ptr(matrix));
+}
+
+void ppgso::Shader::setUniform(Uniform<glm::mat3> uniform, const glm::mat3 &matrix) const {
+  use();
+  glUniformMatrix3fv(uniform.location, 1, GL_FALSE, value_ptr(matrix));
+}
+
+void ppgso::Shader::setUniform(Uniform<float> uniform, float value) const {
+  use();
+  glUniform1f(uniform.location, value);
+}
+
+void ppgso::Shader::setUniform(Uniform<glm::vec2> uniform, glm::vec2 vector) const {
+  use();
+  glUniform2fv(uniform.location, 1, value_ptr(vector));
+}
+
+void ppgso::Shader::setUniform(Uniform<glm::vec3> uniform, glm::vec3 vector) const {
+  use();
+  glUniform3fv(uniform.location, 1, value_ptr(vector));
+}
+
+void ppgso::Shader::setUniform(Uniform<glm::vec4> uniform, glm::vec4 vector) const {
   use();
-  auto uniform = getUniformLocation(name.c_str());
-  glUniform4fv(uniform, 1, value_ptr(vector));
+  glUniform4fv(uniform.location, 1, value_ptr(vector));
 }
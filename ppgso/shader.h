@@ -1,6 +1,7 @@
 #pragma once
 #include <string>
 #include <memory>
+#include <unordered_map>
 
 #include <GL/glew.h>
 #include <glm/glm.hpp>
@@ -9,6 +10,15 @@
 
 namespace ppgso {
 
+  /*!
+   * Pre-resolved location of a shader program uniform input.
+   * The type parameter is the value type the uniform accepts, use Texture for samplers.
+   */
+  template<typename T>
+  struct Uniform {
+    GLint location = -1;
+  };
+
   class Shader {
   public:
 
@@ -24,6 +34,7 @@ namespace ppgso {
 
     /*!
      * Set up the program for use in OpenGL state.
+     * The call is skipped when the program is already in use.
      */
     void use() const;
 
@@ -37,11 +48,33 @@ namespace ppgso {
 
     /*!
      * Get OpenGL uniform location for for the input specified by "name"
+     * Locations of all active uniforms are resolved once when the program is linked.
      *
      * @param name - Name of the shader program input variable.
-     * @return - OpenGL attribute location number.
+     * @return - OpenGL uniform location number, -1 if the program has no such active uniform.
+     */
+    GLint getUniformLocation(const std::string &name) const;
+
+    /*!
+     * Connect a uniform block of the program to a uniform buffer binding point
+     * Programs without the block are left unchanged.
+     *
+     * @param name - Name of the uniform block.
+     * @param binding - Binding point the UniformBuffer is attached to.
+     */
+    void bindUniformBlock(const std::string &name, GLuint binding) const;
+
+    /*!
+     * Get typed handle for the uniform input specified by "name"
+     * Handles can be stored and used to set the uniform without any name lookups.
+     *
+     * @param name - Name of the shader program input variable.
+     * @return - Handle to the uniform, setting an unknown uniform is ignored.
      */
-    GLuint getUniformLocation(const std::string &name) const;
+    template<typename T>
+    Uniform<T> uniform(const std::string &name) const {
+      return Uniform<T>{getUniformLocation(name)};
+    }
 
     /*!
      * Get OpenGL program identifier number.
@@ -108,8 +141,33 @@ namespace ppgso {
      */
     void setUniform(const std::string &name, glm::mat3 matrix) const;
 
+    /*!
+     * Set value of a pre-resolved uniform input
+     *
+     * @param uniform - Handle to the shader program uniform input variable.
+     * @param value - Value to set input to.
+     */
+    void setUniform(Uniform<float> uniform, float value) const;
+    void setUniform(Uniform<glm::vec2> uniform, glm::vec2 vector) const;
+    void setUniform(Uniform<glm::vec3> uniform, glm::vec3 vector) const;
+    void setUniform(Uniform<glm::vec4> uniform, glm::vec4 vector) const;
+    void setUniform(Uniform<glm::mat3> uniform, const glm::mat3 &matrix) const;
+    void setUniform(Uniform<glm::mat4> uniform, const glm::mat4 &matrix) const;
+
+    /*!
+     * Set texture as a pre-resolved uniform input
+     *
+     * @param uniform - Handle to the shader program sampler input variable.
+     * @param texture - Texture to set input to.
+     * @param id - Texture ID to use when multi-texturing (0 is default).
+     */
+    void setUniform(Uniform<Texture> uniform, const Texture &texture, const int id = 0) const;
+
   private:
+    void reflectUniforms();
+
     GLuint program;
+    std::unordered_map<std::string, GLint> uniforms;
   };
 
 }
@@ -4,25 +4,32 @@
 
 ppgso::Texture::Texture(int width, int height) : image{width, height} {
   initGL();
-  update();
 }
 
 ppgso::Texture::Texture(Image&& image) : image{std::move(image)} {
   initGL();
-  update();
 }
 
 ppgso::Texture::~Texture() {
   glDeleteTextures(1, &texture);
 }
 
+void ppgso::Texture::load(Image&& new_image) {
+  // Texture storage is immutable, so a new texture object is needed for a different size
+  glDeleteTextures(1, &texture);
+  image = std::move(new_image);
+  initGL();
+}
+
 void ppgso::Texture::initGL() {
   // Create new texture object
   glGenTextures(1, &texture);
   glBindTexture(GL_TEXTURE_2D, texture);
 
-  // Reserve texture storage
-  glTexStorage2D(GL_TEXTURE_2D, 3, GL_RGB8, image.width, image.height);
+  // Reserve texture storage, small images can not have all 3 mipmap levels
+  GLsizei levels = 1;
+  while (levels < 3 && (image.width >> levels) > 0 && (image.height >> levels) > 0) levels++;
+  glTexStorage2D(GL_TEXTURE_2D, levels, GL_RGB8, image.width, image.height);
 
   // Set up mipmapping
   glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_REPEAT);
@@ -30,6 +30,14 @@ namespace ppgso {
 
     ~Texture();
 
+    /*!
+     * Replace the texture with a new image, the OpenGL storage is re-created to match its size.
+     * Needs to be called from the thread that owns the OpenGL context.
+     *
+     * @param image - Image to use
+     */
+    void load(Image&& image);
+
     /*!
      * Update the OpenGL texture in memory.
      */
@@ -0,0 +1,33 @@
+#include <sstream>
+#include <stdexcept>
+
+#include "uniform_buffer.h"
+
+ppgso::UniformBuffer::UniformBuffer(GLuint binding, size_t size) : binding{binding}, size{size} {
+  glGenBuffers(1, &buffer);
+  glBindBuffer(GL_UNIFORM_BUFFER, buffer);
+  glBufferData(GL_UNIFORM_BUFFER, size, nullptr, GL_DYNAMIC_DRAW);
+  glBindBuffer(GL_UNIFORM_BUFFER, 0);
+
+  glBindBufferBase(GL_UNIFORM_BUFFER, binding, buffer);
+}
+
+ppgso::UniformBuffer::~UniformBuffer() {
+  glDeleteBuffers(1, &buffer);
+}
+
+void ppgso::UniformBuffer::update(const void *data, size_t size, size_t offset) const {
+  if (offset + size > this->size) {
+    std::stringstream msg;
+    msg << "Uniform buffer update of " << size << " bytes at offset " << offset << " exceeds buffer size " << this->size;
+    throw std::runtime_error(msg.str());
+  }
+
+  glBindBuffer(GL_UNIFORM_BUFFER, buffer);
+  glBufferSubData(GL_UNIFORM_BUFFER, offset, size, data);
+  glBindBuffer(GL_UNIFORM_BUFFER, 0);
+}
+
+GLuint ppgso::UniformBuffer::getBinding() const {
+  return binding;
+}
@@ -0,0 +1,60 @@
+#pragma once
+#include <cstddef>
+
+#include <GL/glew.h>
+
+namespace ppgso {
+
+  /*!
+   * Uniform buffer object attached to a fixed binding point.
+   * Every shader program with a uniform block bound to the same point reads the same data,
+   * so values shared by many programs are uploaded only once.
+   */
+  class UniformBuffer {
+  public:
+
+    /*!
+     * Create a buffer and attach it to a uniform block binding point.
+     *
+     * @param binding - Binding point, see Shader::bindUniformBlock.
+     * @param size - Size of the buffer in bytes.
+     */
+    UniformBuffer(GLuint binding, size_t size);
+
+    ~UniformBuffer();
+
+    UniformBuffer(const UniformBuffer&) = delete;
+    UniformBuffer &operator=(const UniformBuffer&) = delete;
+
+    /*!
+     * Replace contents of the buffer.
+     *
+     * @param data - Data laid out according to the std140 rules of the uniform block.
+     * @param size - Number of bytes to write.
+     * @param offset - Offset in bytes to start writing at.
+     */
+    void update(const void *data, size_t size, size_t offset = 0) const;
+
+    /*!
+     * Replace contents of the buffer with a single value.
+     *
+     * @param value - Value laid out according to the std140 rules of the uniform block.
+     */
+    template<typename T>
+    void update(const T &value) const {
+      update(&value, sizeof(T));
+    }
+
+    /*!
+     * Get the binding point the buffer is attached to.
+     *
+     * @return - Binding point.
+     */
+    GLuint getBinding() const;
+
+  private:
+    GLuint buffer = 0;
+    GLuint binding;
+    size_t size;
+  };
+}
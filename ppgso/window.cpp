@@ -144,6 +144,5 @@ ppgso::Window::glfwInstance& ppgso::Window::glfwInstance::Init() {
 }
 
 void ppgso::Window::fpsLimit(bool limit) {
-  if(limit) glfwSwapInterval(1);
-  glfwSwapInterval(0);
+  glfwSwapInterval(limit ? 1 : 0);
 }
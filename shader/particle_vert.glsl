@@ -1,14 +1,21 @@
 #version 330 core
 layout (location = 0) in vec3 vertex;
 
+// Per-instance particle data
+layout (location = 1) in vec3 offset;
+layout (location = 2) in float rotation;
+layout (location = 3) in vec4 color;
+
 out vec2 TexCoords;
 out vec4 ParticleColor;
 
-uniform mat4 projection;
-uniform mat4 view;
-uniform mat4 model;
-uniform vec3 offset;
-uniform vec4 color;
+// Per-frame camera data shared by all programs, see SceneUniforms.h
+layout(std140) uniform Camera {
+    mat4 ProjectionMatrix;
+    mat4 ViewMatrix;
+    vec3 ViewPosition;
+    vec3 LightDirection;
+};
 
 void main()
 {
@@ -17,5 +24,11 @@ void main()
     TexCoords = offset.xy;
     //TexCoords = vertex.xz;
 
-    gl_Position = projection * view * model * vec4((vertex.xyz * scale) + offset, 1.0);
-}
\ No newline at end of file
+    // Spin the quad around the vertical axis of the particle
+    float s = sin(rotation);
+    float c = cos(rotation);
+    vec3 corner = vertex.xyz * scale;
+    corner = vec3(c * corner.x + s * corner.z, corner.y, -s * corner.x + c * corner.z);
+
+    gl_Position = ProjectionMatrix * ViewMatrix * vec4(corner + offset, 1.0);
+}
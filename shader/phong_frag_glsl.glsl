@@ -8,30 +8,35 @@ struct Lights {
     vec3 direction;
 };
 
-uniform float Lights_count;
-uniform Lights lights[20];  // need const and I cant use Lights_count, increase if more than 20 lights (doubt it tbh)
+// Per-frame light data shared by all programs, see SceneUniforms.h
+layout(std140) uniform SceneLights {
+    float Lights_count;
+    Lights lights[20];  // need const and I cant use Lights_count, increase if more than 20 lights (doubt it tbh)
+};
+
+// Per-frame camera data shared by all programs, see SceneUniforms.h
+layout(std140) uniform Camera {
+    mat4 ProjectionMatrix;
+    mat4 ViewMatrix;
+    vec3 ViewPosition;
+    vec3 LightDirection;
+};
 
 
 // A texture is expected as program attribute
 uniform sampler2D Texture;
 
-// Direction of directional-light
-uniform vec3 LightDirection;
-
 // (optional) Transparency
 uniform float Transparency;
 
 // (optional) Texture offset
 uniform vec2 TextureOffset;
 
-//material properties
-uniform float materialShininess;
-uniform float materialDiffuse;
-uniform float materialSpecular;
-
-uniform mat4  ViewMatrix;
-
-uniform vec3 ViewPosition;
+//material properties, passed from the vertex shader so they can also come from instance data
+flat in vec3 Material;
+float materialShininess;
+float materialDiffuse;
+float materialSpecular;
 
 // From vertex Shader
 in vec2 texCoord;
@@ -51,6 +56,9 @@ vec3 directionalLight(vec3 lightDirection, vec3 normalVec3, vec3 viewDir);
 vec3 spotLight(Lights light, vec3 normalVec3, vec3 fragPos, vec3 viewDir);
 
 void main() {
+    materialShininess = Material.x;
+    materialDiffuse = Material.y;
+    materialSpecular = Material.z;
 
     //float diffuse = max(dot(normalVec4, vec4(normalize(LightDirection), 1.0f)), 0.0f);
 
@@ -68,7 +76,7 @@ void main() {
 
     result = directionalLight(LightDirection, normalVec3, viewDirection); //Directional
 
-    for(int i = 0; i <= Lights_count; i++){
+    for(int i = 0; i < Lights_count; i++){
         if(lights[i].type == 0){ //Point
             result += pointLight(lights[i], normalVec3, FragPosition, viewDirection);
         }
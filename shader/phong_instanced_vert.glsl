@@ -0,0 +1,47 @@
+#version 330
+
+// The inputs will be fed by the vertex buffer objects
+layout(location = 0) in vec3 Position;
+layout(location = 1) in vec2 TexCoord;
+layout(location = 2) in vec3 Normal;
+
+// Per-frame camera data shared by all programs, see SceneUniforms.h
+layout(std140) uniform Camera {
+    mat4 ProjectionMatrix;
+    mat4 ViewMatrix;
+    vec3 ViewPosition;
+    vec3 LightDirection;
+};
+
+// Per-instance model matrix and material properties (shininess, diffuse, specular)
+layout(location = 3) in mat4 ModelMatrix;
+layout(location = 7) in vec4 InstanceMaterial;
+
+// This will be passed to the fragment shader
+out vec2 texCoord;
+
+// Normal to pass to the fragment shader
+out vec3 normalVec3;
+out vec4 normalVec4;
+
+out vec3 FragPosition;
+out vec3 FragPositionS;
+
+// Material properties for the fragment shader
+flat out vec3 Material;
+
+void main() {
+    // Copy the input to the fragment shader
+    texCoord = TexCoord;
+    Material = InstanceMaterial.xyz;
+
+    // Normal in world coordinates
+    normalVec4 = normalize(ModelMatrix * vec4(Normal, 0.0f));
+    normalVec3 = normalize(Normal);
+
+    FragPosition = vec3(ModelMatrix * vec4(Position, 1.0));
+    FragPositionS = Position;
+
+    // Calculate the final position on screen
+    gl_Position = ProjectionMatrix * ViewMatrix * ModelMatrix * vec4(Position, 1.0);
+}
@@ -5,11 +5,22 @@ layout(location = 0) in vec3 Position;
 layout(location = 1) in vec2 TexCoord;
 layout(location = 2) in vec3 Normal;
 
+// Per-frame camera data shared by all programs, see SceneUniforms.h
+layout(std140) uniform Camera {
+    mat4 ProjectionMatrix;
+    mat4 ViewMatrix;
+    vec3 ViewPosition;
+    vec3 LightDirection;
+};
+
 // Matrices as program attributes
-uniform mat4 ProjectionMatrix;
-uniform mat4 ViewMatrix;
 uniform mat4 ModelMatrix;
 
+//material properties
+uniform float materialShininess;
+uniform float materialDiffuse;
+uniform float materialSpecular;
+
 // This will be passed to the fragment shader
 out vec2 texCoord;
 
@@ -20,9 +31,13 @@ out vec4 normalVec4;
 out vec3 FragPosition;
 out vec3 FragPositionS;
 
+// Material properties for the fragment shader
+flat out vec3 Material;
+
 void main() {
     // Copy the input to the fragment shader
     texCoord = TexCoord;
+    Material = vec3(materialShininess, materialDiffuse, materialSpecular);
 
     // Normal in world coordinates
     normalVec4 = normalize(ModelMatrix * vec4(Normal, 0.0f));
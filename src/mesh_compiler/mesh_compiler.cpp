@@ -0,0 +1,63 @@
+// Tool mesh_compiler
+// - Converts Wavefront OBJ files into precompiled binary .mesh files
+// - The binary files store compressed interleaved vertex data, indices and bounds in the layout uploaded to the GPU
+// - Coarser levels of detail are generated by quadric error simplification, each keeps half of the triangles
+// - Triangles are reordered for the vertex cache and vertices for fetching, indices are 16 bit where they fit
+// - ppgso::Mesh memory maps the .mesh file next to the requested .obj file and falls back to OBJ parsing
+// - Usage: mesh_compiler [--levels n] input.obj [output.mesh]
+
+#include <algorithm>
+#include <cstdlib>
+#include <iostream>
+#include <ppgso/ppgso.h>
+
+// Full detail and three coarser levels
+const uint32_t DEFAULT_LEVELS = 4;
+
+int main(int argc, char *argv[]) {
+  uint32_t levels = DEFAULT_LEVELS;
+  std::vector<std::string> files;
+  for (int i = 1; i < argc; i++) {
+    std::string argument = argv[i];
+    if (argument == "--levels" && i + 1 < argc) {
+      levels = (uint32_t) std::max(1, std::atoi(argv[++i]));
+    } else {
+      files.push_back(argument);
+    }
+  }
+
+  if (files.empty() || files.size() > 2) {
+    std::cerr << "Usage: " << argv[0] << " [--levels n] input.obj [output.mesh]" << std::endl;
+    return EXIT_FAILURE;
+  }
+
+  std::string input = files[0];
+  std::string output = files.size() == 2 ? files[1] : ppgso::MeshData::binaryPath(input);
+
+  try {
+    auto data = ppgso::MeshData::loadObj(input);
+    data.generateLevels(levels);
+    data.optimize();
+    data.saveBinary(output);
+
+    size_t vertices = 0, indices = 0;
+    for (auto &shape : data.shapes) {
+      vertices += shape.vertexCount;
+      indices += shape.levels[0].indexCount;
+    }
+    std::cout << input << " -> " << output << " (" << data.shapes.size() << " shapes, "
+              << vertices << " vertices, " << indices << " indices)" << std::endl;
+
+    for (uint32_t level = 1; level < data.levelCount(); level++) {
+      size_t level_indices = 0;
+      for (auto &shape : data.shapes)
+        level_indices += shape.levels[level].indexCount;
+      std::cout << "  level " << level << ": " << level_indices << " indices, error " << data.levelError(level) << std::endl;
+    }
+  } catch (std::exception &e) {
+    std::cerr << e.what() << std::endl;
+    return EXIT_FAILURE;
+  }
+
+  return EXIT_SUCCESS;
+}
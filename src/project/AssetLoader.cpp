@@ -0,0 +1,126 @@
+#include <algorithm>
+#include <chrono>
+#include <exception>
+
+#include "AssetLoader.h"
+
+AssetLoader &AssetLoader::instance() {
+    static AssetLoader loader;
+    return loader;
+}
+
+AssetLoader::AssetLoader() {
+    // Leave one core for the OpenGL thread
+    auto cores = std::thread::hardware_concurrency();
+    auto count = cores > 2 ? cores - 1 : 1;
+    for (unsigned int i = 0; i < count; i++)
+        workers.emplace_back(&AssetLoader::work, this);
+}
+
+AssetLoader::~AssetLoader() {
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        stopping = true;
+    }
+    decodeReady.notify_all();
+    for (auto &worker : workers)
+        worker.join();
+}
+
+void AssetLoader::loadMesh(const std::shared_ptr<ppgso::Mesh> &mesh, const std::string &objFile) {
+    loadMesh(mesh, [objFile]() { return ppgso::MeshData::load(objFile); });
+}
+
+void AssetLoader::loadMesh(const std::shared_ptr<ppgso::Mesh> &mesh, std::function<ppgso::MeshData()> build) {
+    std::weak_ptr<ppgso::Mesh> target = mesh;
+    submit([target, build]() -> std::function<void()> {
+        // MeshData is move only, share it with the upload job
+        auto data = std::make_shared<ppgso::MeshData>(build());
+        return [target, data]() {
+            if (auto mesh = target.lock())
+                mesh->upload(*data);
+        };
+    });
+}
+
+void AssetLoader::loadTexture(const std::shared_ptr<ppgso::Texture> &texture, const std::string &bmpFile) {
+    std::weak_ptr<ppgso::Texture> target = texture;
+    submit([target, bmpFile]() -> std::function<void()> {
+        auto image = std::make_shared<ppgso::Image>(ppgso::image::loadBMP(bmpFile));
+        return [target, image]() {
+            if (auto texture = target.lock())
+                texture->load(std::move(*image));
+        };
+    });
+}
+
+void AssetLoader::submit(std::function<std::function<void()>()> decode) {
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        decodeJobs.push_back(std::move(decode));
+        inFlight++;
+    }
+    decodeReady.notify_one();
+}
+
+void AssetLoader::work() {
+    while (true) {
+        std::function<std::function<void()>()> decode;
+        {
+            std::unique_lock<std::mutex> lock(mutex);
+            decodeReady.wait(lock, [this] { return stopping || !decodeJobs.empty(); });
+            if (stopping) return;
+            decode = std::move(decodeJobs.front());
+            decodeJobs.pop_front();
+        }
+
+        std::function<void()> upload;
+        try {
+            upload = decode();
+        } catch (...) {
+            // Report the failure on the OpenGL thread, same as a synchronous load would
+            auto error = std::current_exception();
+            upload = [error]() { std::rethrow_exception(error); };
+        }
+
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            uploadJobs.push_back(std::move(upload));
+        }
+        uploadReady.notify_all();
+    }
+}
+
+void AssetLoader::processUploads(double budget) {
+    auto start = std::chrono::steady_clock::now();
+    while (true) {
+        std::function<void()> upload;
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            if (uploadJobs.empty()) return;
+            upload = std::move(uploadJobs.front());
+            uploadJobs.pop_front();
+            inFlight--;
+        }
+        upload();
+
+        std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+        if (budget >= 0 && elapsed.count() > budget) return;
+    }
+}
+
+void AssetLoader::finish() {
+    while (true) {
+        {
+            std::unique_lock<std::mutex> lock(mutex);
+            uploadReady.wait(lock, [this] { return inFlight == 0 || !uploadJobs.empty(); });
+            if (inFlight == 0) return;
+        }
+        processUploads();
+    }
+}
+
+size_t AssetLoader::pending() {
+    std::lock_guard<std::mutex> lock(mutex);
+    return inFlight;
+}
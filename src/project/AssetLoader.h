@@ -0,0 +1,95 @@
+#ifndef PPGSO_ASSETLOADER_H
+#define PPGSO_ASSETLOADER_H
+
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <ppgso/ppgso.h>
+
+/*!
+ * Two stage asset loading pipeline
+ * Worker threads decode OBJ/mesh and BMP files into CPU side buffers,
+ * the thread owning the OpenGL context then uploads them by draining the upload queue
+ * Resources are created empty and filled once their upload job runs
+ */
+class AssetLoader {
+public:
+    /*!
+     * Get the process-wide loader, worker threads are started on first use
+     * @return Loader instance
+     */
+    static AssetLoader &instance();
+
+    ~AssetLoader();
+
+    AssetLoader(const AssetLoader&) = delete;
+    AssetLoader &operator=(const AssetLoader&) = delete;
+
+    /*!
+     * Decode a mesh in the background and upload it into the given mesh
+     * @param mesh - Empty mesh to fill, the upload is skipped if it was released in the meantime
+     * @param objFile - File path to the obj file
+     */
+    void loadMesh(const std::shared_ptr<ppgso::Mesh> &mesh, const std::string &objFile);
+
+    /*!
+     * Build geometry in the background and upload it into the given mesh
+     * @param mesh - Empty mesh to fill, the upload is skipped if it was released in the meantime
+     * @param build - Produces the geometry, runs on a worker thread
+     */
+    void loadMesh(const std::shared_ptr<ppgso::Mesh> &mesh, std::function<ppgso::MeshData()> build);
+
+    /*!
+     * Decode a texture in the background and upload it into the given texture
+     * @param texture - Placeholder texture to fill, the upload is skipped if it was released in the meantime
+     * @param bmpFile - File path to the bmp file
+     */
+    void loadTexture(const std::shared_ptr<ppgso::Texture> &texture, const std::string &bmpFile);
+
+    /*!
+     * Run a job on the worker threads and the job it returns on the thread owning the OpenGL context
+     * @param decode - Background part of the job, returns the part run by processUploads
+     */
+    void submit(std::function<std::function<void()>()> decode);
+
+    /*!
+     * Run finished upload jobs, has to be called from the thread owning the OpenGL context
+     * Decoding errors are rethrown here
+     * @param budget - Time in seconds after which remaining uploads are left for the next call, negative to drain the queue
+     */
+    void processUploads(double budget = -1);
+
+    /*!
+     * Block until every submitted asset is decoded and uploaded
+     */
+    void finish();
+
+    /*!
+     * Get number of assets that are still being decoded or waiting for upload
+     * @return Number of pending assets
+     */
+    size_t pending();
+
+private:
+    AssetLoader();
+
+    void work();
+
+    std::vector<std::thread> workers;
+    std::mutex mutex;
+    std::condition_variable decodeReady;
+    std::condition_variable uploadReady;
+    // Decode jobs run on the workers and return the upload job for the OpenGL thread
+    std::deque<std::function<std::function<void()>()>> decodeJobs;
+    std::deque<std::function<void()>> uploadJobs;
+    size_t inFlight = 0;
+    bool stopping = false;
+};
+
+#endif //PPGSO_ASSETLOADER_H
@@ -0,0 +1,299 @@
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+#include "BoundingVolumeHierarchy.h"
+
+constexpr int32_t BoundingVolumeHierarchy::NONE;
+constexpr float BoundingVolumeHierarchy::MARGIN;
+
+namespace {
+    // Half of the surface area of a box, the insertion cost heuristic only compares these
+    float area(const glm::vec3 &min, const glm::vec3 &max) {
+        auto size = max - min;
+        return size.x * size.y + size.y * size.z + size.z * size.x;
+    }
+
+    bool contains(const glm::vec3 &outerMin, const glm::vec3 &outerMax, const glm::vec3 &min, const glm::vec3 &max) {
+        return glm::all(glm::lessThanEqual(outerMin, min)) && glm::all(glm::lessThanEqual(max, outerMax));
+    }
+
+    bool overlap(const glm::vec3 &minA, const glm::vec3 &maxA, const glm::vec3 &minB, const glm::vec3 &maxB) {
+        return glm::all(glm::lessThanEqual(minA, maxB)) && glm::all(glm::lessThanEqual(minB, maxA));
+    }
+}
+
+int32_t BoundingVolumeHierarchy::insert(uint32_t id, const glm::vec3 &center, float radius) {
+    auto leaf = allocate();
+    auto &node = nodes[leaf];
+    node.id = id;
+    node.center = center;
+    node.radius = radius;
+    node.min = center - glm::vec3(radius + MARGIN);
+    node.max = center + glm::vec3(radius + MARGIN);
+    insertLeaf(leaf);
+    leaves++;
+    return leaf;
+}
+
+void BoundingVolumeHierarchy::remove(int32_t proxy) {
+    removeLeaf(proxy);
+    release(proxy);
+    leaves--;
+}
+
+bool BoundingVolumeHierarchy::move(int32_t proxy, const glm::vec3 &center, float radius) {
+    auto &node = nodes[proxy];
+    node.center = center;
+    node.radius = radius;
+    if (contains(node.min, node.max, center - glm::vec3(radius), center + glm::vec3(radius)))
+        return false;
+
+    removeLeaf(proxy);
+    nodes[proxy].min = center - glm::vec3(radius + MARGIN);
+    nodes[proxy].max = center + glm::vec3(radius + MARGIN);
+    insertLeaf(proxy);
+    return true;
+}
+
+void BoundingVolumeHierarchy::setId(int32_t proxy, uint32_t id) {
+    nodes[proxy].id = id;
+}
+
+void BoundingVolumeHierarchy::clear() {
+    nodes.clear();
+    root = NONE;
+    freeList = NONE;
+    leaves = 0;
+}
+
+size_t BoundingVolumeHierarchy::size() const {
+    return leaves;
+}
+
+void BoundingVolumeHierarchy::query(const Frustum &frustum, std::vector<uint32_t> &ids) {
+    if (root == NONE) return;
+
+    for (auto array : {&candidateX, &candidateY, &candidateZ, &candidateRadius})
+        array->clear();
+    candidateIds.clear();
+
+    stack.clear();
+    stack.push_back(root);
+    while (!stack.empty()) {
+        auto index = stack.back();
+        stack.pop_back();
+        auto &node = nodes[index];
+
+        auto containment = frustum.classify(node.min, node.max);
+        if (containment == Frustum::OUTSIDE) continue;
+        if (containment == Frustum::INSIDE) {
+            collect(index, ids);
+        } else if (node.leaf()) {
+            // The box is only partially visible, the sphere inside it may still be hidden
+            candidateX.push_back(node.center.x);
+            candidateY.push_back(node.center.y);
+            candidateZ.push_back(node.center.z);
+            candidateRadius.push_back(node.radius);
+            candidateIds.push_back(node.id);
+        } else {
+            stack.push_back(node.left);
+            stack.push_back(node.right);
+        }
+    }
+
+    frustum.intersects(candidateX, candidateY, candidateZ, candidateRadius, visible);
+    for (size_t i = 0; i < candidateIds.size(); i++) {
+        if (visible[i])
+            ids.push_back(candidateIds[i]);
+    }
+}
+
+void BoundingVolumeHierarchy::raycast(const glm::vec3 &origin, const glm::vec3 &direction, std::vector<uint32_t> &ids) {
+    if (root == NONE) return;
+
+    // Axes the ray runs parallel to get infinite slabs
+    auto inverse = 1.0f / direction;
+
+    hits.clear();
+    stack.clear();
+    stack.push_back(root);
+    while (!stack.empty()) {
+        auto &node = nodes[stack.back()];
+        stack.pop_back();
+
+        // Slab test, the ray has to enter all three slabs before leaving any of them
+        auto t0 = (node.min - origin) * inverse;
+        auto t1 = (node.max - origin) * inverse;
+        auto tMin = glm::min(t0, t1);
+        auto tMax = glm::max(t0, t1);
+        float enter = std::max({tMin.x, tMin.y, tMin.z});
+        float exit = std::min({tMax.x, tMax.y, tMax.z});
+        if (exit < std::max(enter, 0.0f)) continue;
+
+        if (!node.leaf()) {
+            stack.push_back(node.left);
+            stack.push_back(node.right);
+            continue;
+        }
+
+        // Ray and sphere, the nearest intersection in front of the origin counts
+        auto offset = node.center - origin;
+        float along = glm::dot(offset, direction);
+        float distance2 = glm::dot(offset, offset) - along * along;
+        float radius2 = node.radius * node.radius;
+        if (distance2 > radius2) continue;
+        float half = std::sqrt(radius2 - distance2);
+        float t = along - half;
+        if (t < 0) t = along + half;
+        if (t < 0) continue;
+        hits.push_back({t, node.id});
+    }
+
+    std::sort(hits.begin(), hits.end());
+    for (auto &hit : hits)
+        ids.push_back(hit.second);
+}
+
+void BoundingVolumeHierarchy::overlaps(const glm::vec3 &min, const glm::vec3 &max, std::vector<uint32_t> &ids) {
+    if (root == NONE) return;
+
+    stack.clear();
+    stack.push_back(root);
+    while (!stack.empty()) {
+        auto &node = nodes[stack.back()];
+        stack.pop_back();
+        if (!overlap(node.min, node.max, min, max)) continue;
+
+        if (!node.leaf()) {
+            stack.push_back(node.left);
+            stack.push_back(node.right);
+            continue;
+        }
+
+        // Distance from the sphere center to the closest point of the box
+        auto closest = glm::clamp(node.center, min, max) - node.center;
+        if (glm::dot(closest, closest) <= node.radius * node.radius)
+            ids.push_back(node.id);
+    }
+}
+
+int32_t BoundingVolumeHierarchy::allocate() {
+    int32_t index;
+    if (freeList == NONE) {
+        index = (int32_t) nodes.size();
+        nodes.emplace_back();
+    } else {
+        index = freeList;
+        freeList = nodes[index].parent;
+    }
+    nodes[index] = Node{};
+    return index;
+}
+
+void BoundingVolumeHierarchy::release(int32_t node) {
+    nodes[node].parent = freeList;
+    nodes[node].left = NONE;
+    nodes[node].right = NONE;
+    freeList = node;
+}
+
+void BoundingVolumeHierarchy::insertLeaf(int32_t leaf) {
+    if (root == NONE) {
+        root = leaf;
+        nodes[leaf].parent = NONE;
+        return;
+    }
+
+    auto min = nodes[leaf].min;
+    auto max = nodes[leaf].max;
+
+    // Walk down towards the child whose box grows the least, stop when making a new parent here is cheaper
+    auto index = root;
+    while (!nodes[index].leaf()) {
+        auto &node = nodes[index];
+        float combined = area(glm::min(node.min, min), glm::max(node.max, max));
+        float here = 2.0f * combined;
+        // Every ancestor below this node grows by the same amount as this node
+        float inherited = 2.0f * (combined - area(node.min, node.max));
+
+        float costs[2];
+        int32_t children[2] = {node.left, node.right};
+        for (int c = 0; c < 2; c++) {
+            auto &child = nodes[children[c]];
+            float grown = area(glm::min(child.min, min), glm::max(child.max, max));
+            costs[c] = (child.leaf() ? grown : grown - area(child.min, child.max)) + inherited;
+        }
+
+        if (here < costs[0] && here < costs[1]) break;
+        index = costs[0] < costs[1] ? children[0] : children[1];
+    }
+
+    // The sibling and the new leaf share a new parent in the place of the sibling
+    auto sibling = index;
+    auto oldParent = nodes[sibling].parent;
+    auto newParent = allocate();
+    nodes[newParent].parent = oldParent;
+    nodes[newParent].left = sibling;
+    nodes[newParent].right = leaf;
+    nodes[sibling].parent = newParent;
+    nodes[leaf].parent = newParent;
+
+    if (oldParent == NONE) {
+        root = newParent;
+    } else if (nodes[oldParent].left == sibling) {
+        nodes[oldParent].left = newParent;
+    } else {
+        nodes[oldParent].right = newParent;
+    }
+
+    refit(newParent);
+}
+
+void BoundingVolumeHierarchy::removeLeaf(int32_t leaf) {
+    if (leaf == root) {
+        root = NONE;
+        return;
+    }
+
+    auto parent = nodes[leaf].parent;
+    auto grandParent = nodes[parent].parent;
+    auto sibling = nodes[parent].left == leaf ? nodes[parent].right : nodes[parent].left;
+
+    if (grandParent == NONE) {
+        root = sibling;
+        nodes[sibling].parent = NONE;
+    } else {
+        if (nodes[grandParent].left == parent)
+            nodes[grandParent].left = sibling;
+        else
+            nodes[grandParent].right = sibling;
+        nodes[sibling].parent = grandParent;
+        refit(grandParent);
+    }
+    release(parent);
+}
+
+void BoundingVolumeHierarchy::refit(int32_t node) {
+    while (node != NONE) {
+        auto &current = nodes[node];
+        current.min = glm::min(nodes[current.left].min, nodes[current.right].min);
+        current.max = glm::max(nodes[current.left].max, nodes[current.right].max);
+        node = current.parent;
+    }
+}
+
+void BoundingVolumeHierarchy::collect(int32_t node, std::vector<uint32_t> &ids) {
+    subtree.clear();
+    subtree.push_back(node);
+    while (!subtree.empty()) {
+        auto &current = nodes[subtree.back()];
+        subtree.pop_back();
+        if (current.leaf()) {
+            ids.push_back(current.id);
+        } else {
+            subtree.push_back(current.left);
+            subtree.push_back(current.right);
+        }
+    }
+}
@@ -0,0 +1,148 @@
+#ifndef PPGSO_BOUNDINGVOLUMEHIERARCHY_H
+#define PPGSO_BOUNDINGVOLUMEHIERARCHY_H
+
+#include <cstdint>
+#include <vector>
+
+#include <glm/glm.hpp>
+
+#include "Frustum.h"
+
+/*!
+ * Dynamic tree of axis aligned boxes over world space bounding spheres
+ * Every leaf holds a sphere and a caller chosen id, its box is enlarged by a margin
+ * so small movements only update the sphere and leave the tree untouched
+ * Leaves that leave their enlarged box are taken out and inserted again at the place
+ * with the lowest growth of the surface area of the boxes above them
+ * Serves frustum, ray and box queries that return the ids of the leaves they hit
+ */
+class BoundingVolumeHierarchy {
+public:
+    static constexpr int32_t NONE = -1;
+
+    /*!
+     * Add a leaf
+     * @param id - Value returned by the queries for this leaf
+     * @param center - Center of the bounding sphere in world space
+     * @param radius - Radius of the bounding sphere, has to be finite
+     * @return Proxy identifying the leaf for move and remove
+     */
+    int32_t insert(uint32_t id, const glm::vec3 &center, float radius);
+
+    /*!
+     * Remove a leaf
+     * @param proxy - Proxy returned by insert
+     */
+    void remove(int32_t proxy);
+
+    /*!
+     * Update the bounding sphere of a leaf
+     * @param proxy - Proxy returned by insert
+     * @param center - New center of the sphere in world space
+     * @param radius - New radius of the sphere
+     * @return true if the leaf left its enlarged box and was inserted again
+     */
+    bool move(int32_t proxy, const glm::vec3 &center, float radius);
+
+    /*!
+     * Change the id returned for a leaf
+     * @param proxy - Proxy returned by insert
+     * @param id - New id
+     */
+    void setId(int32_t proxy, uint32_t id);
+
+    /*!
+     * Remove all leaves
+     */
+    void clear();
+
+    /*!
+     * Find leaves whose sphere touches the frustum
+     * Subtrees completely inside are accepted without testing their leaves, the spheres of
+     * leaves in partially visible boxes are tested together in one batch
+     * @param frustum - Frustum to test against
+     * @param ids - Ids of the visible leaves are appended in no particular order
+     */
+    void query(const Frustum &frustum, std::vector<uint32_t> &ids);
+
+    /*!
+     * Find leaves whose sphere is hit by a ray
+     * @param origin - Start of the ray in world space
+     * @param direction - Normalized direction of the ray
+     * @param ids - Ids of the hit leaves are appended, nearest hit first
+     */
+    void raycast(const glm::vec3 &origin, const glm::vec3 &direction, std::vector<uint32_t> &ids);
+
+    /*!
+     * Find leaves whose sphere overlaps a box
+     * @param min - Minimum corner of the box in world space
+     * @param max - Maximum corner of the box in world space
+     * @param ids - Ids of the overlapping leaves are appended in no particular order
+     */
+    void overlaps(const glm::vec3 &min, const glm::vec3 &max, std::vector<uint32_t> &ids);
+
+    /*!
+     * Get the number of leaves
+     * @return Number of inserted and not removed leaves
+     */
+    size_t size() const;
+
+private:
+    // Distance added around each sphere when its leaf box is built
+    static constexpr float MARGIN = 1.0f;
+
+    struct Node {
+        glm::vec3 min, max;
+        // Free nodes use parent as the next entry of the free list
+        int32_t parent = NONE;
+        int32_t left = NONE, right = NONE;
+        // Leaf data
+        uint32_t id = 0;
+        glm::vec3 center;
+        float radius = 0;
+
+        bool leaf() const { return left == NONE; }
+    };
+
+    int32_t allocate();
+    void release(int32_t node);
+
+    /*!
+     * Link a leaf into the tree next to the node whose box grows the least
+     * @param leaf - Allocated leaf with its box set
+     */
+    void insertLeaf(int32_t leaf);
+
+    /*!
+     * Unlink a leaf from the tree, its parent is released and the sibling takes its place
+     * @param leaf - Linked leaf
+     */
+    void removeLeaf(int32_t leaf);
+
+    /*!
+     * Recompute the boxes of a node and all its ancestors from their children
+     * @param node - First node to refit
+     */
+    void refit(int32_t node);
+
+    /*!
+     * Append the ids of all leaves below a node
+     * @param node - Root of the subtree
+     * @param ids - Ids are appended here
+     */
+    void collect(int32_t node, std::vector<uint32_t> &ids);
+
+    std::vector<Node> nodes;
+    int32_t root = NONE;
+    int32_t freeList = NONE;
+    size_t leaves = 0;
+
+    // Scratch space of the queries, kept to avoid allocations every frame
+    std::vector<int32_t> stack, subtree;
+    std::vector<float> candidateX, candidateY, candidateZ, candidateRadius;
+    std::vector<uint32_t> candidateIds;
+    std::vector<uint8_t> visible;
+    std::vector<std::pair<float, uint32_t>> hits;
+};
+
+#endif //PPGSO_BOUNDINGVOLUMEHIERARCHY_H
@@ -15,7 +15,12 @@ Camera::Camera(float fow, float ratio, float near, float far) {
 }
 
 void Camera::update() {
+    previousPosition = position;
+    previousLookAtPos = lookAtPos;
+
     if((mode == TRANSITIONING || mode == BEZIER) && currentStep < steps){
+        // A transition starts with a jump to its first position, which is not blended
+        bool starting = currentStep == 0;
         if(mode == BEZIER){
             position = bezierCurve(points,  currentStep / steps);
             lookAtPos = glm::lerp(startLookAt, endLookAt, currentStep / steps);
@@ -26,19 +31,63 @@ void Camera::update() {
             lookAtPos = glm::lerp(startLookAt, endLookAt, currentStep / steps);
             currentStep++;
         }
+        if (starting)
+            snap();
     }
 
-    viewMatrix = lookAt(position, lookAtPos, up);
+    updateViewMatrix();
 
     //std::cout << "Cam Position:" << position.x << " " << position.y << " " << position.z << " "  << std::endl;
     //std::cout << "Cam lookAtPos:" << lookAtPos.x << " " << lookAtPos.y << " " << lookAtPos.z << " "  << std::endl;
 }
 
+glm::vec3 Camera::cast(double u, double v) {
+    // Create point in Screen coordinates
+    glm::vec4 screenPosition{u, v, 0.0f, 1.0f};
+
+    // Use inverse matrices to get the point in world coordinates
+    auto invProjection = glm::inverse(projectionMatrix);
+    auto invView = glm::inverse(viewMatrix);
+
+    // Compute position on the camera plane
+    auto planePosition = invView * invProjection * screenPosition;
+    planePosition /= planePosition.w;
+
+    // Create direction vector
+    auto direction = glm::normalize(planePosition - glm::vec4{position, 1.0f});
+    return glm::vec3{direction};
+}
+
+std::vector<glm::vec3> Camera::upcomingPath(int samples) {
+    std::vector<glm::vec3> path;
+    if ((mode != TRANSITIONING && mode != BEZIER) || currentStep >= steps)
+        return path;
+
+    for (int i = 1; i <= samples; i++) {
+        float t = (currentStep + (steps - currentStep) * i / samples) / steps;
+        if (mode == BEZIER)
+            path.push_back(bezierCurve(points, t));
+        else
+            path.push_back(glm::lerp(startPosition, endPosition, t));
+    }
+    return path;
+}
+
+void Camera::updateViewMatrix() {
+    viewMatrix = lookAt(position, lookAtPos, up);
+}
+
+void Camera::snap() {
+    previousPosition = position;
+    previousLookAtPos = lookAtPos;
+}
+
 void Camera::moveForward(){
     float temp = position.y;
     position += SPEED * lookAtVec;
     position.y = temp;
     lookAtPos = position + lookAtVec;
+    snap();
 }
 
 void Camera::moveBack(){
@@ -46,6 +95,7 @@ void Camera::moveBack(){
     position -= SPEED * lookAtVec;
     position.y = temp;
     lookAtPos = position + lookAtVec;
+    snap();
 }
 
 void Camera::moveLeft(){
@@ -54,6 +104,7 @@ void Camera::moveLeft(){
     position -= SPEED * rotateTowards;
     position.y = temp;
     lookAtPos = position + lookAtVec;
+    snap();
 }
 
 void Camera::moveRight(){
@@ -62,16 +113,19 @@ void Camera::moveRight(){
     position += SPEED * rotateTowards;
     position.y = temp;
     lookAtPos = position + lookAtVec;
+    snap();
 }
 
 void Camera::moveUp(){
     position += SPEED * up;
     lookAtPos = position + lookAtVec;
+    snap();
 }
 
 void Camera::moveDown(){
     position -= SPEED * up;
     lookAtPos = position + lookAtVec;
+    snap();
 }
 
 void Camera::mouseUpdate(const glm::vec2 &newMousePosition) {
@@ -108,6 +162,8 @@ void Camera::mouseUpdate(const glm::vec2 &newMousePosition) {
 
 
     lookAtPos = position + front;
+    // Looking around takes effect right away, the position may still be blended during a transition
+    previousLookAtPos = previousPosition + front;
 
     lastCurPosX = xpos;
     lastCurPosY = ypos;
@@ -131,6 +187,7 @@ void Camera::setToStationary(glm::vec3 setToPosition, glm::vec3 setToLookAt) {
     mode = STATIONARY;
     position = setToPosition;
     lookAtPos = setToLookAt;
+    snap();
 }
 
 void Camera::setToWASD(glm::vec3 setToPosition, glm::vec3 setToLookAt) {
@@ -138,6 +195,7 @@ void Camera::setToWASD(glm::vec3 setToPosition, glm::vec3 setToLookAt) {
     position = setToPosition;
     lookAtVec = {.0f,.0f,-1.0f};
     lookAtPos = position + lookAtVec;
+    snap();
 }
 
 
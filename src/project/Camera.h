@@ -1,5 +1,6 @@
 #pragma once
 #include <memory>
+#include <vector>
 
 #include <glm/glm.hpp>
 #include <ppgso/ppgso.h>
@@ -26,6 +27,10 @@ public:
     glm::vec3 lookAtPos{-5.0f,-10.0f,4.0f};
     glm::vec3 lookAtVec{.0f,.0f,-1.0f};
 
+    // Position and lookAtPos at the previous simulation tick, frames drawn between ticks blend towards the current ones
+    glm::vec3 previousPosition{.0f,.0f,.0f};
+    glm::vec3 previousLookAtPos{-5.0f,-10.0f,4.0f};
+
     float yaw = -90.0f;
     float pitch = 0.0f;
 
@@ -55,17 +60,31 @@ public:
     Camera(float fow = 45.0f, float ratio = 1.0f, float near = 0.1f, float far = 10.0f);
 
     /*!
-     * Update Camera viewMatrix based on up, position and back vectors
+     * Advance transitions by one simulation tick and update the viewMatrix
+     * The position and lookAtPos before the tick are kept in previousPosition and previousLookAtPos
      */
     void update();
 
+    /*!
+     * Update Camera viewMatrix based on up, position and lookAtPos, without advancing transitions
+     */
+    void updateViewMatrix();
+
     /*!
      * Get direction vector in world coordinates through camera projection plane
      * @param u - camera projection plane horizontal coordinate [-1,1]
      * @param v - camera projection plane vertical coordinate [-1,1]
      * @return Normalized vector from camera position to position on the camera projection plane
      */
-    //glm::vec3 cast(double u, double v);
+    glm::vec3 cast(double u, double v);
+
+    /*!
+     * Get positions the camera passes through during the rest of its scripted transition
+     * @param samples - Number of positions to return, spread evenly over the remaining steps
+     * @return Positions along the remaining path ending with its destination, empty when not transitioning
+     */
+    std::vector<glm::vec3> upcomingPath(int samples);
+
     void moveForward();
     void moveBack();
     void moveLeft();
@@ -81,6 +100,11 @@ public:
     glm::vec3 bezierCurve(const std::vector<glm::vec3>& points, float t);
     void transitionToBezier(const std::vector<glm::vec3>& points, glm::vec3 startLookAt, glm::vec3 endLookAt, float numberOfSteps);
 
+private:
+    /*!
+     * Make the current position and lookAtPos also the previous ones, so jumps and input are not blended between ticks
+     */
+    void snap();
 
 
 };
@@ -0,0 +1,32 @@
+#include <algorithm>
+
+#include "FixedTimestep.h"
+
+FixedTimestep::FixedTimestep(float tickRate, int maxTicks) : tick{1.0f / tickRate}, maxTicks{maxTicks} {
+}
+
+void FixedTimestep::setTickRate(float tickRate) {
+    tick = 1.0f / tickRate;
+}
+
+float FixedTimestep::tickTime() const {
+    return tick;
+}
+
+int FixedTimestep::advance(float frameTime) {
+    accumulator += std::max(frameTime, 0.0f);
+
+    int ticks = 0;
+    while (accumulator >= tick && ticks < maxTicks) {
+        accumulator -= tick;
+        ticks++;
+    }
+
+    // Catching up on the dropped time would make the next frames just as long
+    accumulator = std::min(accumulator, tick);
+    return ticks;
+}
+
+float FixedTimestep::alpha() const {
+    return std::min(accumulator / tick, 1.0f);
+}
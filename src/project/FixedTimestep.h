@@ -0,0 +1,51 @@
+#ifndef PPGSO_FIXEDTIMESTEP_H
+#define PPGSO_FIXEDTIMESTEP_H
+
+/*!
+ * Accumulator that turns variable frame times into a whole number of fixed simulation ticks
+ * The simulation then advances by the same time step no matter how fast frames are rendered,
+ * the time left over is reported as a fraction of a tick for interpolating between the last two ticks
+ * The number of ticks per frame is limited, time beyond the limit is dropped and the simulation slows down
+ * instead of falling further behind after a long frame
+ */
+class FixedTimestep {
+public:
+    /*!
+     * Create the accumulator
+     * @param tickRate - Simulation ticks per second
+     * @param maxTicks - Maximum number of ticks run for one frame
+     */
+    explicit FixedTimestep(float tickRate = 60.0f, int maxTicks = 5);
+
+    /*!
+     * Change the number of simulation ticks per second, time already accumulated is kept
+     * @param tickRate - Simulation ticks per second
+     */
+    void setTickRate(float tickRate);
+
+    /*!
+     * Get the time step of one tick
+     * @return Time in seconds simulated by one tick
+     */
+    float tickTime() const;
+
+    /*!
+     * Add the time of a frame
+     * @param frameTime - Time in seconds since the previous frame
+     * @return Number of ticks to simulate for this frame
+     */
+    int advance(float frameTime);
+
+    /*!
+     * Get how far the frame is past the last tick
+     * @return Elapsed part of the next tick in [0, 1]
+     */
+    float alpha() const;
+
+private:
+    float tick;
+    int maxTicks;
+    float accumulator = 0;
+};
+
+#endif //PPGSO_FIXEDTIMESTEP_H
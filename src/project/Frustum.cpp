@@ -0,0 +1,81 @@
+#include "Frustum.h"
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define PPGSO_FRUSTUM_SSE
+#include <emmintrin.h>
+#endif
+
+void Frustum::extract(const glm::mat4 &viewProjection) {
+    // Rows of the matrix, glm stores columns
+    glm::vec4 rows[4];
+    for (int i = 0; i < 4; i++)
+        rows[i] = {viewProjection[0][i], viewProjection[1][i], viewProjection[2][i], viewProjection[3][i]};
+
+    // Left, right, bottom, top, near and far
+    planes[0] = rows[3] + rows[0];
+    planes[1] = rows[3] - rows[0];
+    planes[2] = rows[3] + rows[1];
+    planes[3] = rows[3] - rows[1];
+    planes[4] = rows[3] + rows[2];
+    planes[5] = rows[3] - rows[2];
+
+    // Normalize so plane distances can be compared with sphere radii
+    for (auto &plane : planes)
+        plane /= glm::length(glm::vec3(plane));
+}
+
+bool Frustum::intersects(const glm::vec3 &center, float radius) const {
+    for (auto &plane : planes) {
+        if (glm::dot(glm::vec3(plane), center) + plane.w < -radius)
+            return false;
+    }
+    return true;
+}
+
+Frustum::Containment Frustum::classify(const glm::vec3 &min, const glm::vec3 &max) const {
+    auto result = INSIDE;
+    for (auto &plane : planes) {
+        // Corners of the box furthest along and against the plane normal
+        glm::vec3 positive{plane.x >= 0 ? max.x : min.x, plane.y >= 0 ? max.y : min.y, plane.z >= 0 ? max.z : min.z};
+        glm::vec3 negative{plane.x >= 0 ? min.x : max.x, plane.y >= 0 ? min.y : max.y, plane.z >= 0 ? min.z : max.z};
+        if (glm::dot(glm::vec3(plane), positive) + plane.w < 0)
+            return OUTSIDE;
+        if (glm::dot(glm::vec3(plane), negative) + plane.w < 0)
+            result = INTERSECTS;
+    }
+    return result;
+}
+
+void Frustum::intersects(const std::vector<float> &x, const std::vector<float> &y, const std::vector<float> &z,
+                         const std::vector<float> &radius, std::vector<uint8_t> &visible) const {
+    size_t count = radius.size();
+    visible.resize(count);
+    size_t i = 0;
+
+#ifdef PPGSO_FRUSTUM_SSE
+    for (; i + 4 <= count; i += 4) {
+        __m128 cx = _mm_loadu_ps(&x[i]);
+        __m128 cy = _mm_loadu_ps(&y[i]);
+        __m128 cz = _mm_loadu_ps(&z[i]);
+        __m128 negativeRadius = _mm_sub_ps(_mm_setzero_ps(), _mm_loadu_ps(&radius[i]));
+
+        // A sphere is visible while it is not completely behind any plane
+        __m128 inside = _mm_castsi128_ps(_mm_set1_epi32(-1));
+        for (auto &plane : planes) {
+            __m128 distance = _mm_add_ps(_mm_add_ps(_mm_mul_ps(cx, _mm_set1_ps(plane.x)),
+                                                    _mm_mul_ps(cy, _mm_set1_ps(plane.y))),
+                                         _mm_add_ps(_mm_mul_ps(cz, _mm_set1_ps(plane.z)),
+                                                    _mm_set1_ps(plane.w)));
+            inside = _mm_and_ps(inside, _mm_cmpge_ps(distance, negativeRadius));
+        }
+
+        int mask = _mm_movemask_ps(inside);
+        for (int k = 0; k < 4; k++)
+            visible[i + k] = (uint8_t) ((mask >> k) & 1);
+    }
+#endif
+
+    // Remaining spheres, or all of them without SSE
+    for (; i < count; i++)
+        visible[i] = intersects({x[i], y[i], z[i]}, radius[i]) ? 1 : 0;
+}
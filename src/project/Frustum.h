@@ -0,0 +1,61 @@
+#ifndef PPGSO_FRUSTUM_H
+#define PPGSO_FRUSTUM_H
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include <glm/glm.hpp>
+
+/*!
+ * View frustum as six planes in world space, used to skip objects the camera can not see
+ * Bounding spheres are tested in batches, four at a time with SSE when the target supports it
+ */
+class Frustum {
+public:
+    // Result of testing a box against the frustum
+    enum Containment {
+        OUTSIDE,
+        INTERSECTS,
+        INSIDE
+    };
+
+    /*!
+     * Extract the planes from a combined projection and view matrix
+     * @param viewProjection - projectionMatrix * viewMatrix of the camera
+     */
+    void extract(const glm::mat4 &viewProjection);
+
+    /*!
+     * Test a single bounding sphere
+     * @param center - Center of the sphere in world space
+     * @param radius - Radius of the sphere
+     * @return false if the sphere is completely outside of the frustum
+     */
+    bool intersects(const glm::vec3 &center, float radius) const;
+
+    /*!
+     * Test an axis aligned box, used to accept or reject whole subtrees of a bounding volume hierarchy
+     * @param min - Minimum corner of the box in world space
+     * @param max - Maximum corner of the box in world space
+     * @return OUTSIDE when the box is behind a plane, INSIDE when it is in front of all of them
+     */
+    Containment classify(const glm::vec3 &min, const glm::vec3 &max) const;
+
+    /*!
+     * Test packed bounding spheres, all arrays have to be of the same size
+     * @param x - X coordinates of the sphere centers in world space
+     * @param y - Y coordinates of the sphere centers in world space
+     * @param z - Z coordinates of the sphere centers in world space
+     * @param radius - Radii of the spheres, infinity for objects that are never culled
+     * @param visible - Set to 1 for spheres touching the frustum and 0 for the others
+     */
+    void intersects(const std::vector<float> &x, const std::vector<float> &y, const std::vector<float> &z,
+                    const std::vector<float> &radius, std::vector<uint8_t> &visible) const;
+
+private:
+    // Plane normals point inside, a point is inside when dot(normal, point) + distance >= 0
+    glm::vec4 planes[6];
+};
+
+#endif //PPGSO_FRUSTUM_H
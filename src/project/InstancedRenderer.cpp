@@ -0,0 +1,93 @@
+#include <algorithm>
+#include <cstddef>
+
+#include "InstancedRenderer.h"
+#include "ResourceCache.h"
+
+#include <shaders/phong_instanced_vert_glsl.h>
+#include <shaders/phong_frag_glsl_glsl.h>
+
+InstancedRenderer::~InstancedRenderer() {
+    for (auto &entry : batches)
+        glDeleteBuffers(1, &entry.second.buffer);
+}
+
+void InstancedRenderer::submit(const std::shared_ptr<ppgso::Mesh> &mesh, const std::shared_ptr<ppgso::Texture> &texture,
+                               const glm::mat4 &modelMatrix, const glm::vec3 &materialProperties, size_t level) {
+    auto &batch = batches[mesh.get()];
+
+    // A released mesh may have left its address to a new one, start over with a fresh buffer
+    if (batch.mesh.lock() != mesh) {
+        glDeleteBuffers(1, &batch.buffer);
+        batch = Batch{};
+        batch.mesh = mesh;
+    }
+
+    auto &group = batch.groups[{texture.get(), level}];
+    group.texture = texture;
+    group.instances.push_back({modelMatrix, glm::vec4{materialProperties, 0}});
+}
+
+void InstancedRenderer::flush() {
+    if (!shader) {
+        shader = ResourceCache::shader(phong_instanced_vert_glsl, phong_frag_glsl_glsl);
+        textureUniform = shader->uniform<ppgso::Texture>("Texture");
+    }
+
+    shader->use();
+    lastDrawCalls = 0;
+
+    for (auto entry = batches.begin(); entry != batches.end();) {
+        auto &batch = entry->second;
+        auto mesh = batch.mesh.lock();
+        if (!mesh) {
+            glDeleteBuffers(1, &batch.buffer);
+            entry = batches.erase(entry);
+            continue;
+        }
+
+        if (batch.buffer == 0) {
+            glGenBuffers(1, &batch.buffer);
+            mesh->setInstanceBuffer(batch.buffer, sizeof(Instance), {
+                    {3, 4, offsetof(Instance, modelMatrix) + 0 * sizeof(glm::vec4)},
+                    {4, 4, offsetof(Instance, modelMatrix) + 1 * sizeof(glm::vec4)},
+                    {5, 4, offsetof(Instance, modelMatrix) + 2 * sizeof(glm::vec4)},
+                    {6, 4, offsetof(Instance, modelMatrix) + 3 * sizeof(glm::vec4)},
+                    {7, 4, offsetof(Instance, material)}
+            });
+        }
+
+        for (auto &groupEntry : batch.groups) {
+            auto &group = groupEntry.second;
+            if (group.instances.empty()) continue;
+
+            // Orphan the storage so the upload does not wait for the previous draw from the same buffer
+            auto size = group.instances.size() * sizeof(Instance);
+            glBindBuffer(GL_ARRAY_BUFFER, batch.buffer);
+            batch.capacity = std::max(batch.capacity, size);
+            glBufferData(GL_ARRAY_BUFFER, batch.capacity, nullptr, GL_STREAM_DRAW);
+            glBufferSubData(GL_ARRAY_BUFFER, 0, size, group.instances.data());
+            glBindBuffer(GL_ARRAY_BUFFER, 0);
+
+            shader->setUniform(textureUniform, *group.texture);
+            mesh->renderInstanced((GLsizei) group.instances.size(), groupEntry.first.second);
+            lastDrawCalls++;
+        }
+
+        // Keep the groups for the next frame but release the textures
+        for (auto groupEntry = batch.groups.begin(); groupEntry != batch.groups.end();) {
+            if (groupEntry->second.instances.empty()) {
+                groupEntry = batch.groups.erase(groupEntry);
+            } else {
+                groupEntry->second.instances.clear();
+                groupEntry->second.texture.reset();
+                ++groupEntry;
+            }
+        }
+        ++entry;
+    }
+}
+
+size_t InstancedRenderer::drawCalls() const {
+    return lastDrawCalls;
+}
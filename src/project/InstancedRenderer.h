@@ -0,0 +1,73 @@
+#ifndef PPGSO_INSTANCEDRENDERER_H
+#define PPGSO_INSTANCEDRENDERER_H
+
+#include <map>
+#include <memory>
+#include <utility>
+#include <vector>
+
+#include <ppgso/ppgso.h>
+
+/*!
+ * Collects phong shaded objects during Scene::render and draws all copies sharing a mesh, texture and level of detail
+ * with a single instanced draw call
+ * Model matrices and material properties of the copies are streamed into a per-mesh instance buffer
+ */
+class InstancedRenderer {
+public:
+    InstancedRenderer() = default;
+    ~InstancedRenderer();
+
+    InstancedRenderer(const InstancedRenderer&) = delete;
+    InstancedRenderer &operator=(const InstancedRenderer&) = delete;
+
+    /*!
+     * Queue one copy of a mesh for drawing at the end of the frame
+     * @param mesh - Mesh to draw
+     * @param texture - Texture to draw the mesh with
+     * @param modelMatrix - Model matrix of the copy
+     * @param materialProperties - Shininess, diffuse and specular factors of the copy
+     * @param level - Level of detail of the mesh to draw the copy with
+     */
+    void submit(const std::shared_ptr<ppgso::Mesh> &mesh, const std::shared_ptr<ppgso::Texture> &texture,
+                const glm::mat4 &modelMatrix, const glm::vec3 &materialProperties, size_t level = 0);
+
+    /*!
+     * Draw all queued copies, one draw call per unique mesh, texture and level of detail, and clear the queue
+     */
+    void flush();
+
+    /*!
+     * Get number of draw calls issued by the last flush
+     * @return Number of instanced draw calls
+     */
+    size_t drawCalls() const;
+
+private:
+    // Layout of the per-instance data read by phong_instanced_vert.glsl
+    struct Instance {
+        glm::mat4 modelMatrix;
+        glm::vec4 material;
+    };
+
+    struct Group {
+        std::shared_ptr<ppgso::Texture> texture;
+        std::vector<Instance> instances;
+    };
+
+    struct Batch {
+        // The batch does not keep the mesh alive between frames
+        std::weak_ptr<ppgso::Mesh> mesh;
+        GLuint buffer = 0;
+        size_t capacity = 0;
+        // Grouped by texture and level of detail
+        std::map<std::pair<ppgso::Texture *, size_t>, Group> groups;
+    };
+
+    std::map<ppgso::Mesh *, Batch> batches;
+    std::shared_ptr<ppgso::Shader> shader;
+    ppgso::Uniform<ppgso::Texture> textureUniform;
+    size_t lastDrawCalls = 0;
+};
+
+#endif //PPGSO_INSTANCEDRENDERER_H
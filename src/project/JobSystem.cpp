@@ -0,0 +1,142 @@
+#include <algorithm>
+
+#include "JobSystem.h"
+
+namespace {
+    // Queue owned by the current thread, workers set it when they start
+    thread_local size_t currentQueue = 0;
+}
+
+JobSystem &JobSystem::instance() {
+    static JobSystem jobs;
+    return jobs;
+}
+
+JobSystem::JobSystem() {
+    // The thread joining a group works as well, so one worker less than there are cores
+    auto cores = std::thread::hardware_concurrency();
+    auto count = cores > 1 ? cores - 1 : 0;
+    for (unsigned int i = 0; i <= count; i++)
+        queues.push_back(std::make_unique<Queue>());
+    for (unsigned int i = 1; i <= count; i++)
+        workers.emplace_back(&JobSystem::work, this, i);
+}
+
+JobSystem::~JobSystem() {
+    {
+        std::lock_guard<std::mutex> lock(sleepMutex);
+        stopping = true;
+    }
+    wake.notify_all();
+    for (auto &worker : workers)
+        worker.join();
+}
+
+size_t JobSystem::threads() const {
+    return queues.size();
+}
+
+void JobSystem::fork(Group &group, std::function<void()> job) {
+    group.pending++;
+    // Counted before it is queued, so a thief never takes a job that is not counted yet
+    queued++;
+    auto &queue = *queues[currentQueue];
+    {
+        std::lock_guard<std::mutex> lock(queue.mutex);
+        queue.jobs.push_back([&group, job = std::move(job)]() {
+            try {
+                job();
+            } catch (...) {
+                std::lock_guard<std::mutex> errorLock(group.mutex);
+                if (!group.error) group.error = std::current_exception();
+            }
+            group.pending--;
+        });
+    }
+
+    // Taking the lock orders the notification after a worker checked for jobs and went to sleep
+    {
+        std::lock_guard<std::mutex> lock(sleepMutex);
+    }
+    wake.notify_one();
+}
+
+void JobSystem::join(Group &group) {
+    while (group.pending > 0) {
+        if (!runOne(currentQueue))
+            std::this_thread::yield();
+    }
+
+    if (group.error) {
+        auto error = group.error;
+        group.error = nullptr;
+        std::rethrow_exception(error);
+    }
+}
+
+void JobSystem::parallelFor(size_t count, size_t grain, const std::function<void(size_t begin, size_t end)> &body) {
+    if (count == 0) return;
+    grain = std::max<size_t>(grain, 1);
+
+    // Not worth queueing when there is one chunk or no worker to take the others
+    if (count <= grain || workers.empty()) {
+        body(0, count);
+        return;
+    }
+
+    Group group;
+    for (size_t begin = grain; begin < count; begin += grain) {
+        auto end = std::min(begin + grain, count);
+        fork(group, [&body, begin, end]() { body(begin, end); });
+    }
+
+    // The first chunk runs right away on this thread
+    std::exception_ptr error;
+    try {
+        body(0, grain);
+    } catch (...) {
+        error = std::current_exception();
+    }
+    join(group);
+    if (error) std::rethrow_exception(error);
+}
+
+bool JobSystem::runOne(size_t index) {
+    std::function<void()> job;
+
+    // Newest job of the own queue
+    {
+        auto &queue = *queues[index];
+        std::lock_guard<std::mutex> lock(queue.mutex);
+        if (!queue.jobs.empty()) {
+            job = std::move(queue.jobs.back());
+            queue.jobs.pop_back();
+        }
+    }
+
+    // Oldest job of another queue, starting from the next one so thieves spread over the queues
+    for (size_t i = 1; !job && i < queues.size(); i++) {
+        auto &queue = *queues[(index + i) % queues.size()];
+        std::lock_guard<std::mutex> lock(queue.mutex);
+        if (!queue.jobs.empty()) {
+            job = std::move(queue.jobs.front());
+            queue.jobs.pop_front();
+        }
+    }
+
+    if (!job) return false;
+    queued--;
+    job();
+    return true;
+}
+
+void JobSystem::work(size_t index) {
+    currentQueue = index;
+    while (true) {
+        if (runOne(index)) continue;
+
+        std::unique_lock<std::mutex> lock(sleepMutex);
+        wake.wait(lock, [this] { return stopping || queued > 0; });
+        if (stopping) return;
+    }
+}
@@ -0,0 +1,107 @@
+#ifndef PPGSO_JOBSYSTEM_H
+#define PPGSO_JOBSYSTEM_H
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+/*!
+ * Fork-join job system with work stealing
+ * Every worker thread and the main thread own a queue, jobs forked by a thread go to its own queue
+ * Owners take their newest job first so nested forks stay cache warm, idle threads steal the oldest
+ * job of another queue, which is usually the biggest piece of remaining work
+ * Joining a group runs queued jobs on the waiting thread instead of blocking it
+ */
+class JobSystem {
+public:
+    /*!
+     * Jobs forked together, join waits until all of them finished
+     * The first exception thrown by one of the jobs is rethrown by join
+     */
+    class Group {
+    public:
+        Group() = default;
+        Group(const Group&) = delete;
+        Group &operator=(const Group&) = delete;
+
+    private:
+        friend class JobSystem;
+        std::atomic<size_t> pending{0};
+        std::mutex mutex;
+        std::exception_ptr error;
+    };
+
+    /*!
+     * Get the process-wide job system, worker threads are started on first use
+     * @return Job system instance
+     */
+    static JobSystem &instance();
+
+    ~JobSystem();
+
+    JobSystem(const JobSystem&) = delete;
+    JobSystem &operator=(const JobSystem&) = delete;
+
+    /*!
+     * Queue a job, it may run on any thread until the group is joined
+     * @param group - Group the job belongs to, has to outlive the job
+     * @param job - Function to run
+     */
+    void fork(Group &group, std::function<void()> job);
+
+    /*!
+     * Wait until all jobs of a group finished, running queued jobs meanwhile
+     * @param group - Group to wait for
+     */
+    void join(Group &group);
+
+    /*!
+     * Split a range into chunks and process them in parallel, returns when all chunks are done
+     * @param count - Size of the range
+     * @param grain - Number of elements processed by one job
+     * @param body - Called with the begin and end of each chunk
+     */
+    void parallelFor(size_t count, size_t grain, const std::function<void(size_t begin, size_t end)> &body);
+
+    /*!
+     * Get number of threads running jobs, including the calling thread
+     * @return Number of threads
+     */
+    size_t threads() const;
+
+private:
+    JobSystem();
+
+    struct Queue {
+        std::mutex mutex;
+        std::deque<std::function<void()>> jobs;
+    };
+
+    /*!
+     * Run one job from the own queue, or one stolen from another queue
+     * @param index - Queue of the calling thread
+     * @return false if all queues were empty
+     */
+    bool runOne(size_t index);
+
+    void work(size_t index);
+
+    // Queue 0 belongs to threads that are not workers
+    std::vector<std::unique_ptr<Queue>> queues;
+    std::vector<std::thread> workers;
+
+    // Idle workers sleep until jobs are queued
+    std::mutex sleepMutex;
+    std::condition_variable wake;
+    std::atomic<size_t> queued{0};
+    bool stopping = false;
+};
+
+#endif //PPGSO_JOBSYSTEM_H
@@ -3,8 +3,9 @@
 //
 #include "LightSource.h"
 #include "Scene.h"
+#include "ResourceCache.h"
 
-#include <shaders/color_vert_glsl.h>
+#include <shaders/scene_color_vert_glsl.h>
 #include <shaders/color_frag_glsl.h>
 
 std::string COLORS[] = {"RED",
@@ -25,10 +26,13 @@ int colorCount = 12;
 
 // shared resources
 LightSource::LightSource(glm::vec3 position,float scale, glm::vec3 color, float brightness) {
-    // Initialize static resources if needed
-    if (!shader) shader = std::make_unique<ppgso::Shader>(color_vert_glsl, color_frag_glsl);
-    if (!mesh) mesh = std::make_unique<ppgso::Mesh>("sphere.obj");
-    if (!texture) texture = std::make_unique<ppgso::Texture>(ppgso::image::loadBMP("white.bmp"));
+    // Get shared resources
+    shader = ResourceCache::shader(scene_color_vert_glsl, color_frag_glsl);
+    mesh = ResourceCache::mesh("sphere.obj");
+    texture = ResourceCache::texture("white.bmp");
+
+    uniforms.modelMatrix = shader->uniform<glm::mat4>("ModelMatrix");
+    uniforms.overallColor = shader->uniform<glm::vec3>("OverallColor");
 
     this->type = 0;
     this->position = position;
@@ -37,10 +41,13 @@ LightSource::LightSource(glm::vec3 position,float scale, glm::vec3 color, float
     this->brightness = brightness;
 }
 LightSource::LightSource(glm::vec3 position,glm::vec3 direction,float scale, glm::vec3 color, float brightness) {
-    // Initialize static resources if needed
-    if (!shader) shader = std::make_unique<ppgso::Shader>(color_vert_glsl, color_frag_glsl);
-    if (!mesh) mesh = std::make_unique<ppgso::Mesh>("sphere.obj");
-    if (!texture) texture = std::make_unique<ppgso::Texture>(ppgso::image::loadBMP("white.bmp"));
+    // Get shared resources
+    shader = ResourceCache::shader(scene_color_vert_glsl, color_frag_glsl);
+    mesh = ResourceCache::mesh("sphere.obj");
+    texture = ResourceCache::texture("white.bmp");
+
+    uniforms.modelMatrix = shader->uniform<glm::mat4>("ModelMatrix");
+    uniforms.overallColor = shader->uniform<glm::vec3>("OverallColor");
 
     this->type = 1;
     this->position = position;
@@ -51,29 +58,30 @@ LightSource::LightSource(glm::vec3 position,glm::vec3 direction,float scale, glm
 }
 
 bool LightSource::update(Scene &scene, float dt) {
-    generateModelMatrix();
     return true;
 }
 
 void LightSource::render(Scene &scene) {
-    shader->use();
-
-    // Set up light
-    shader->setUniform("LightDirection", scene.lightDirection);
-
-    // use camera
-    shader->setUniform("ProjectionMatrix", scene.camera->projectionMatrix);
-    shader->setUniform("ViewMatrix", scene.camera->viewMatrix);
+    // The color shader does not sample a texture
+    scene.queue.submit(RenderQueue::OPAQUE, *this, *shader, nullptr, mesh.get());
+}
 
+void LightSource::draw(Scene &scene) {
     // render mesh
-    shader->setUniform("ModelMatrix", modelMatrix);
-    shader->setUniform("Texture", *texture);
-
-    shader->setUniform("OverallColor", color);
+    shader->setUniform(uniforms.modelMatrix, modelMatrix);
+    shader->setUniform(uniforms.overallColor, color);
 
     mesh->render();
 }
 
+bool LightSource::getBounds(glm::vec3 &center, float &radius) const {
+    return meshBounds(*mesh, center, radius);
+}
+
+bool LightSource::parallelUpdate() const {
+    return true;
+}
+
 
 void LightSource::setColor(const std::string& colorName) {
     this->color = returnColor(colorName);
@@ -126,5 +134,5 @@ glm::vec3 LightSource::returnColor(const std::string& colorName){
 }
 
 glm::vec3 LightSource::randomColor(){
-    return returnColor(COLORS[rand() % colorCount]);
+    return returnColor(COLORS[random.range(0, colorCount)]);
 }
\ No newline at end of file
@@ -5,6 +5,7 @@
 #include <ppgso/ppgso.h>
 
 #include "Object.h"
+#include "Random.h"
 #ifndef PPGSO_LIGHTSOURCE_H
 #define PPGSO_LIGHTSOURCE_H
 
@@ -12,10 +13,18 @@
 
 class LightSource : public Object {
 private:
-    // Static resources (Shared between instances)
-    std::unique_ptr<ppgso::Mesh> mesh;
-    std::unique_ptr<ppgso::Shader> shader;
-    std::unique_ptr<ppgso::Texture> texture;
+    // Shared resources (Shared between instances through the ResourceCache)
+    std::shared_ptr<ppgso::Mesh> mesh;
+    std::shared_ptr<ppgso::Shader> shader;
+    std::shared_ptr<ppgso::Texture> texture;
+
+    // Color shader inputs, resolved once in the constructor
+    struct {
+        ppgso::Uniform<glm::mat4> modelMatrix;
+        ppgso::Uniform<glm::vec3> overallColor;
+    } uniforms;
+
+    Random random;
 
 
 
@@ -47,4 +56,27 @@ public:
      * @param scene Scene to render in
      */
     void render(Scene &scene) override;
+
+    /*!
+     * Draw the queued light model
+     * @param scene Scene to render in
+     */
+    void draw(Scene &scene) override;
+
+    /*!
+     * Get the bounding sphere of the mesh
+     * @param center - Set to the center of the sphere
+     * @param radius - Set to the radius of the sphere
+     * @return false while the mesh is still loading
+     */
+    bool getBounds(glm::vec3 &center, float &radius) const override;
+
+    /*!
+     * Light models do not change on update
+     * @return true
+     */
+    bool parallelUpdate() const override;
 };
+
+// Lights contributing to the shading of a scene, in the order they are uploaded to the shaders
+using SceneLights = SlotMap<LightSource>;
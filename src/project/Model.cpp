@@ -1,18 +1,23 @@
 #include "Model.h"
 #include "Scene.h"
+#include "ResourceCache.h"
 
-#include <shaders/diffuse_vert_glsl.h>
-#include <shaders/diffuse_frag_glsl.h>
-
-#include <shaders/phong_vert_glsl_glsl.h>
-#include <shaders/phong_frag_glsl_glsl.h>
+namespace {
+    // Largest error a level of detail may show, as part of half the screen height, about a pixel at 1080p
+    const float LOD_TOLERANCE = 0.002f;
+    // Part of the tolerance a coarser level has to stay under before the model switches to it
+    const float LOD_HYSTERESIS = 0.8f;
+}
 
 // shared resources
 Model::Model(const std::string& modelName, const std::string& textureName) {
-    // Initialize static resources if needed
-    if (!shader) shader = std::make_unique<ppgso::Shader>(phong_vert_glsl_glsl, phong_frag_glsl_glsl);
-    if (!mesh) mesh = std::make_unique<ppgso::Mesh>(modelName);
-    if (!texture) texture = std::make_unique<ppgso::Texture>(ppgso::image::loadBMP(textureName));
+    // Get shared resources, they are only loaded by the first instance that uses them
+    mesh = ResourceCache::mesh(modelName);
+    texture = ResourceCache::texture(textureName);
+}
+
+Model::Model(std::shared_ptr<ppgso::Mesh> mesh, std::shared_ptr<ppgso::Texture> texture)
+        : mesh{std::move(mesh)}, texture{std::move(texture)} {
 }
 
 bool Model::update(Scene &scene, float dt) {
@@ -28,47 +33,42 @@ bool Model::update(Scene &scene, float dt) {
             currentStep++;
         }
     }
-    generateModelMatrix();
     return true;
 }
 
 void Model::render(Scene &scene) {
-    shader->use();
-
-    // Set up light
-    shader->setUniform("LightDirection", scene.lightDirection);
-
-    // use camera
-    shader->setUniform("ProjectionMatrix", scene.camera->projectionMatrix);
-    shader->setUniform("ViewMatrix", scene.camera->viewMatrix);
-
-    shader->setUniform("ViewPosition", scene.camera->position);
-
-    // render mesh
-    shader->setUniform("ModelMatrix", modelMatrix);
-    shader->setUniform("Texture", *texture);
-
-    shader->setUniform("Lights_count", (float) scene.lights->size());
+    lod = selectLevel(scene);
+    scene.instances.submit(mesh, texture, modelMatrix, materialProperties, lod);
+}
 
-    //std::cout << scene.lights->size() << std::endl;
+size_t Model::selectLevel(const Scene &scene) const {
+    auto levels = mesh->getLevelCount();
+    if (levels < 2 || !scene.camera) return 0;
+
+    // Errors are in model space, the largest axis scale bounds how far they stretch in the world
+    auto scale = glm::max(glm::length(glm::vec3(modelMatrix[0])),
+                          glm::max(glm::length(glm::vec3(modelMatrix[1])), glm::length(glm::vec3(modelMatrix[2]))));
+    auto center = glm::vec3(modelMatrix * glm::vec4(mesh->getBoundingCenter(), 1));
+    auto distance = glm::length(center - scene.camera->position) - mesh->getBoundingRadius() * scale;
+    if (distance <= 0) return 0;
+
+    // Size on screen of a model space unit at the nearest point of the bounding sphere
+    auto projected = scale * scene.camera->projectionMatrix[1][1] / distance;
+
+    auto level = std::min(lod, levels - 1);
+    while (level > 0 && mesh->getLevelError(level) * projected > LOD_TOLERANCE)
+        level--;
+    while (level + 1 < levels && mesh->getLevelError(level + 1) * projected < LOD_TOLERANCE * LOD_HYSTERESIS)
+        level++;
+    return level;
+}
 
-    shader->setUniform("materialShininess", this->materialProperties.x);
-    shader->setUniform("materialDiffuse", this->materialProperties.y);
-    shader->setUniform("materialSpecular", this->materialProperties.z);
+bool Model::getBounds(glm::vec3 &center, float &radius) const {
+    return meshBounds(*mesh, center, radius);
+}
 
-    std::list<std::unique_ptr<LightSource>>::iterator it;
-    int i = 0;
-    for (it = scene.lights->begin(); it != scene.lights->end(); ++it){
-        shader->setUniform("lights[" + std::to_string(i) + "].type", (*it)->type);
-        shader->setUniform("lights[" + std::to_string(i) + "].position", (*it)->position);
-        shader->setUniform("lights[" + std::to_string(i) + "].color", (*it)->color);
-        shader->setUniform("lights[" + std::to_string(i) + "].brightness", (*it)->brightness);
-        if((*it)->type == 1) {
-            shader->setUniform("lights[" + std::to_string(i) + "].direction", (*it)->direction);
-        }
-        i++;
-    }
-    mesh->render();
+bool Model::parallelUpdate() const {
+    return true;
 }
 
 void Model::transitionTo(glm::vec3 startPosition, glm::vec3 startLookAt, glm::vec3 endPosition, glm::vec3 endLookAt,
@@ -21,11 +21,23 @@ private:
 
     std::vector<glm::vec3> points;
 
+    // Level of detail the model was last drawn with
+    size_t lod = 0;
+
+    /*!
+     * Pick the coarsest level of detail whose error stays below the tolerance on screen
+     * Coarser levels are only taken once their error is clearly below it, so models at the switching
+     * distance do not flip between two levels every frame
+     * @param scene - Scene with the camera the model is seen from
+     * @return Level of detail to draw
+     */
+    size_t selectLevel(const Scene &scene) const;
+
 protected:
-    // Static resources (Shared between instances)
-    std::unique_ptr<ppgso::Mesh> mesh;
-    std::unique_ptr<ppgso::Shader> shader;
-    std::unique_ptr<ppgso::Texture> texture;
+    // Shared resources (Shared between instances through the ResourceCache)
+    // Copies sharing mesh and texture are drawn together by the scene's InstancedRenderer
+    std::shared_ptr<ppgso::Mesh> mesh;
+    std::shared_ptr<ppgso::Texture> texture;
 
     glm::vec3 color = {0, 0, 1};
 
@@ -35,6 +47,13 @@ public:
      */
     Model(const std::string& modelName, const std::string& textureName);
 
+    /*!
+     * Create a model from resources already taken from the ResourceCache
+     * @param mesh - Shared mesh
+     * @param texture - Shared texture
+     */
+    Model(std::shared_ptr<ppgso::Mesh> mesh, std::shared_ptr<ppgso::Texture> texture);
+
     /*!
      * Update player position considering keyboard inputs
      * @param scene Scene to update
@@ -44,11 +63,25 @@ public:
     bool update(Scene &scene, float dt) override;
 
     /*!
-     * Render player
+     * Queue player for instanced rendering at the end of the frame
      * @param scene Scene to render in
      */
     void render(Scene &scene) override;
 
+    /*!
+     * Get the bounding sphere of the mesh
+     * @param center - Set to the center of the sphere
+     * @param radius - Set to the radius of the sphere
+     * @return false while the mesh is still loading
+     */
+    bool getBounds(glm::vec3 &center, float &radius) const override;
+
+    /*!
+     * Models only animate their own transform
+     * @return true
+     */
+    bool parallelUpdate() const override;
+
     void transitionTo(glm::vec3 startPosition, glm::vec3 startLookAt, glm::vec3 endPosition, glm::vec3 endLookAt, float numberOfSteps);
     float binomialCoefficient(int n, int i);
     glm::vec3 bezierCurve(const std::vector<glm::vec3>& points, float t);
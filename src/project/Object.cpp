@@ -1,16 +1,31 @@
-#define GLM_ENABLE_EXPERIMENTAL
-#include <glm/glm.hpp>
-#include <glm/gtc/matrix_transform.hpp>
-#include <glm/gtx/euler_angles.hpp>
-#include <glm/gtx/transform.hpp>
+#include <ppgso/ppgso.h>
 
 #include "Object.h"
+#include "TransformSystem.h"
 
 void Object::generateModelMatrix() {
-    modelMatrix =
-            glm::translate(glm::mat4(1.0f), position)
-            * glm::orientate4(rotation)
-            * glm::scale(glm::mat4(1.0f), scale);
+    if (!transformChanged()) return;
+    modelMatrix = TransformSystem::compose(position, rotation, scale);
+    markTransformBuilt();
+}
+
+bool Object::transformChanged() const {
+    return !transformBuilt || position != builtPosition || rotation != builtRotation || scale != builtScale;
+}
+
+void Object::markTransformBuilt() {
+    builtPosition = position;
+    builtRotation = rotation;
+    builtScale = scale;
+    transformBuilt = true;
+}
+
+bool Object::meshBounds(const ppgso::Mesh &mesh, glm::vec3 &center, float &radius) {
+    // Bounds arrive with the geometry, until then the object is drawn without culling
+    if (mesh.empty()) return false;
+    center = mesh.getBoundingCenter();
+    radius = mesh.getBoundingRadius();
+    return true;
 }
 
 void Object::setMaterialProperties(float shininess, float diffuse, float specular) {
@@ -2,12 +2,19 @@
 #include <memory>
 #include <list>
 #include <map>
+#include <vector>
 
 #include <glm/glm.hpp>
 
+#include "SlotMap.h"
+
 // Forward declare a scene
 class Scene;
 
+namespace ppgso {
+    class Mesh;
+}
+
 /*!
  *  Abstract scene object interface
  *  All objects in the scene should be able to update and render
@@ -36,6 +43,13 @@ public:
      */
     virtual void render(Scene &scene) = 0;
 
+    /*!
+     * Draw the object for a packet it queued in the scene's RenderQueue from render
+     * The shader of the packet is in use and its texture bound, only the object's own uniforms are left to set
+     * @param scene
+     */
+    virtual void draw(Scene &scene) {};
+
 
     /*!
      * Event to be called when the object is clicked
@@ -43,6 +57,22 @@ public:
      */
     virtual void onClick(Scene &scene) {};
 
+    /*!
+     * Get the bounding sphere of the rendered geometry in model space, used to skip objects outside of the view
+     * @param center - Set to the center of the sphere
+     * @param radius - Set to the radius of the sphere
+     * @return false if the object has no bounds and is always rendered
+     */
+    virtual bool getBounds(glm::vec3 &center, float &radius) const { return false; }
+
+    /*!
+     * Tell whether update only changes the object itself and reads nothing other objects change during update
+     * Such objects are updated in parallel on the JobSystem, the others one by one after them on the main thread
+     * Scene::spawn and Scene::destroy may still be called from a parallel update
+     * @return true if update can run on a worker thread
+     */
+    virtual bool parallelUpdate() const { return false; }
+
     void setMaterialProperties(float shininess, float diffuse, float specular);
 
     // Object properties
@@ -53,10 +83,53 @@ public:
 
     glm::vec3 materialProperties = glm::vec3 (32,1,1);
 
+    // Set for objects that do not move once the scene is built, their modelMatrix is only generated once
+    bool staticTransform = false;
+
+    // Object this one is attached to, position, rotation and scale are then relative to it
+    // Has to be set before the object is added to the scene, a removed parent leaves the object in world space
+    SlotHandle<Object> parent;
+
 protected:
     /*!
-     * Generate modelMatrix from position, rotation and scale
+     * Generate modelMatrix from position, rotation and scale right away, ignoring the parent
+     * Only needed when the matrix is used during update, the Scene rebuilds changed matrices after all updates
      */
     void generateModelMatrix();
+
+    /*!
+     * Report the bounds of a mesh from getBounds
+     * @param mesh - Mesh the object renders
+     * @param center - Set to the center of the bounding sphere
+     * @param radius - Set to the radius of the bounding sphere
+     * @return false while the mesh is still loading
+     */
+    static bool meshBounds(const ppgso::Mesh &mesh, glm::vec3 &center, float &radius);
+
+private:
+    friend class TransformSystem;
+
+    /*!
+     * Check whether position, rotation or scale changed since modelMatrix was generated
+     * @return true if modelMatrix is out of date
+     */
+    bool transformChanged() const;
+
+    /*!
+     * Remember the values modelMatrix was generated from
+     */
+    void markTransformBuilt();
+
+    glm::vec3 builtPosition{0,0,0};
+    glm::vec3 builtRotation{0,0,0};
+    glm::vec3 builtScale{1,1,1};
+    bool transformBuilt = false;
+    // TransformSystem pass that last rebuilt modelMatrix, children of objects rebuilt in the same pass follow them
+    uint32_t transformPass = 0;
+    // modelMatrix before the last rebuild, frames rendered between two ticks blend from it
+    glm::mat4 previousModelMatrix{1};
 };
 
+// Packed container of the objects in a scene, changed only between updates through Scene::spawn and Scene::destroy
+// or by the WorldStreamer of the scene
+using SceneObjects = SlotMap<Object>;
@@ -9,7 +9,8 @@
 #include "src/project/objects/Particle.h"
 
 ParticleGenerator::ParticleGenerator(glm::vec3 topBackLeft, glm::vec3 bottomCloseRight, int minSpawnTime,
-                                     int maxSpawnTime, std::string particleObject, std::string particleTexture) {
+                                     int maxSpawnTime, std::string particleObject, std::string particleTexture,
+                                     uint64_t seed) : random{seed} {
     tbl = topBackLeft;
     bcr = bottomCloseRight;
     minst = minSpawnTime;
@@ -17,12 +18,10 @@ ParticleGenerator::ParticleGenerator(glm::vec3 topBackLeft, glm::vec3 bottomClos
     particleObj = std::move(particleObject);
     particleText = std::move(particleTexture);
 
-    spawnThreshold = (rand() % (maxst- minst)) + minst;
+    spawnThreshold = random.range(minst, maxst);
 }
 
 bool ParticleGenerator::update(Scene &scene, float dt) {
-    generateModelMatrix();
-
     // Accumulate time
     lastSpawnedAgo += dt;
 
@@ -30,12 +29,12 @@ bool ParticleGenerator::update(Scene &scene, float dt) {
     if (lastSpawnedAgo > spawnThreshold) {
         auto obj = std::make_unique<Particle>(particleObj, particleText, 1); //TODO maybe be able to change how much a particle can live for
         obj->position = position;
-        obj->position.x += glm::linearRand(-20.0f, 20.0f);
+        obj->position.x += random.range(-20.0f, 20.0f);
 
-        scene.objects->push_back(move(obj));
+        scene.spawn(move(obj));
 
         lastSpawnedAgo = 0;
-        spawnThreshold = (rand() % (maxst- minst)) + minst;
+        spawnThreshold = random.range(minst, maxst);
     }
 
     return true;
@@ -8,6 +8,7 @@
 
 #include "glm/vec3.hpp"
 #include "Object.h"
+#include "Random.h"
 
 class ParticleGenerator final: public Object {
 private:
@@ -22,9 +23,11 @@ private:
     std::string particleObj;
     std::string particleText;
 
+    Random random;
+
 public:
     ParticleGenerator(glm::vec3 topBackLeft, glm::vec3 bottomCloseRight, int minSpawnTime, int maxSpawnTime,
-                      std::string particleObject, std::string particleTexture);
+                      std::string particleObject, std::string particleTexture, uint64_t seed = Random::nextSeed());
 
     bool update(Scene &scene, float dt) override;
 
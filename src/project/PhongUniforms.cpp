@@ -0,0 +1,9 @@
+#include "PhongUniforms.h"
+
+PhongUniforms::PhongUniforms(const ppgso::Shader &shader) {
+    modelMatrix = shader.uniform<glm::mat4>("ModelMatrix");
+    texture = shader.uniform<ppgso::Texture>("Texture");
+    materialShininess = shader.uniform<float>("materialShininess");
+    materialDiffuse = shader.uniform<float>("materialDiffuse");
+    materialSpecular = shader.uniform<float>("materialSpecular");
+}
@@ -0,0 +1,27 @@
+#ifndef PPGSO_PHONGUNIFORMS_H
+#define PPGSO_PHONGUNIFORMS_H
+
+#include <ppgso/ppgso.h>
+
+/*!
+ * Per-object uniform handles of the phong shader, resolved once per object instead of looked up by name every frame
+ * Camera and lights come from the uniform buffers written by the Scene
+ * Handles missing in the program (e.g. when used with the color shader) are ignored when set
+ */
+struct PhongUniforms {
+    ppgso::Uniform<glm::mat4> modelMatrix;
+    ppgso::Uniform<ppgso::Texture> texture;
+    ppgso::Uniform<float> materialShininess;
+    ppgso::Uniform<float> materialDiffuse;
+    ppgso::Uniform<float> materialSpecular;
+
+    PhongUniforms() = default;
+
+    /*!
+     * Resolve handles of the per-object phong shader inputs
+     * @param shader - Shader program to resolve the inputs in
+     */
+    explicit PhongUniforms(const ppgso::Shader &shader);
+};
+
+#endif //PPGSO_PHONGUNIFORMS_H
@@ -0,0 +1,132 @@
+#include "Random.h"
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define PPGSO_RANDOM_SSE
+#include <emmintrin.h>
+#endif
+
+namespace {
+    // Base seed, seeds for keys are derived from it and the sequence handed out by Random::nextSeed starts at it
+    const uint64_t DEFAULT_SEED_BASE = 0x5eed5eed5eed5eedULL;
+    uint64_t seedBase = DEFAULT_SEED_BASE;
+    uint64_t seedSequence = DEFAULT_SEED_BASE;
+
+    // Scale of the 24 bits used for a float in [0, 1)
+    const float FLOAT_SCALE = 1.0f / 16777216.0f;
+
+    // SplitMix64, spreads a seed over the generator state
+    uint64_t splitMix(uint64_t &x) {
+        uint64_t z = (x += 0x9e3779b97f4a7c15ULL);
+        z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ULL;
+        z = (z ^ (z >> 27)) * 0x94d049bb133111ebULL;
+        return z ^ (z >> 31);
+    }
+
+    uint32_t rotl(uint32_t x, int k) {
+        return (x << k) | (x >> (32 - k));
+    }
+
+    // One xoshiro128+ step
+    uint32_t step(uint32_t &s0, uint32_t &s1, uint32_t &s2, uint32_t &s3) {
+        uint32_t result = s0 + s3;
+        uint32_t t = s1 << 9;
+        s2 ^= s0;
+        s3 ^= s1;
+        s1 ^= s2;
+        s0 ^= s3;
+        s2 ^= t;
+        s3 = rotl(s3, 11);
+        return result;
+    }
+}
+
+uint64_t Random::nextSeed() {
+    return splitMix(seedSequence);
+}
+
+uint64_t Random::seedFor(uint64_t key) {
+    // Keys are usually small consecutive indices, mixing them twice keeps neighbouring seeds unrelated
+    uint64_t x = seedBase ^ splitMix(key);
+    return splitMix(x);
+}
+
+void Random::setSeedBase(uint64_t base) {
+    seedBase = base;
+    seedSequence = base;
+}
+
+Random::Random(uint64_t seed) {
+    // The all zero state is the only invalid one, SplitMix64 never yields it for all four words in practice
+    for (int i = 0; i < 4; i += 2) {
+        uint64_t bits = splitMix(seed);
+        state[i] = (uint32_t) bits;
+        state[i + 1] = (uint32_t) (bits >> 32);
+    }
+    for (int generator = 0; generator < 4; generator++) {
+        for (int word = 0; word < 4; word += 2) {
+            uint64_t bits = splitMix(seed);
+            lanes[word][generator] = (uint32_t) bits;
+            lanes[word + 1][generator] = (uint32_t) (bits >> 32);
+        }
+    }
+}
+
+uint32_t Random::next() {
+    return step(state[0], state[1], state[2], state[3]);
+}
+
+float Random::uniform() {
+    return (float) (next() >> 8) * FLOAT_SCALE;
+}
+
+float Random::range(float min, float max) {
+    return min + uniform() * (max - min);
+}
+
+int Random::range(int min, int max) {
+    if (max <= min) return min;
+    return min + (int) (((uint64_t) next() * (uint64_t) (max - min)) >> 32);
+}
+
+void Random::fill(float *values, size_t count, float min, float max) {
+    float scale = (max - min) * FLOAT_SCALE;
+    size_t i = 0;
+
+#ifdef PPGSO_RANDOM_SSE
+    __m128i s0 = _mm_load_si128((const __m128i *) lanes[0]);
+    __m128i s1 = _mm_load_si128((const __m128i *) lanes[1]);
+    __m128i s2 = _mm_load_si128((const __m128i *) lanes[2]);
+    __m128i s3 = _mm_load_si128((const __m128i *) lanes[3]);
+    const __m128 min4 = _mm_set1_ps(min);
+    const __m128 scale4 = _mm_set1_ps(scale);
+    for (; i + 4 <= count; i += 4) {
+        __m128i result = _mm_add_epi32(s0, s3);
+        __m128i t = _mm_slli_epi32(s1, 9);
+        s2 = _mm_xor_si128(s2, s0);
+        s3 = _mm_xor_si128(s3, s1);
+        s1 = _mm_xor_si128(s1, s2);
+        s0 = _mm_xor_si128(s0, s3);
+        s2 = _mm_xor_si128(s2, t);
+        s3 = _mm_or_si128(_mm_slli_epi32(s3, 11), _mm_srli_epi32(s3, 21));
+
+        // Top 24 bits fit the float mantissa exactly
+        __m128 value = _mm_cvtepi32_ps(_mm_srli_epi32(result, 8));
+        _mm_storeu_ps(values + i, _mm_add_ps(min4, _mm_mul_ps(value, scale4)));
+    }
+    _mm_store_si128((__m128i *) lanes[0], s0);
+    _mm_store_si128((__m128i *) lanes[1], s1);
+    _mm_store_si128((__m128i *) lanes[2], s2);
+    _mm_store_si128((__m128i *) lanes[3], s3);
+#else
+    for (; i + 4 <= count; i += 4) {
+        for (int generator = 0; generator < 4; generator++) {
+            uint32_t result = step(lanes[0][generator], lanes[1][generator], lanes[2][generator], lanes[3][generator]);
+            values[i + generator] = min + (float) (result >> 8) * scale;
+        }
+    }
+#endif
+
+    // Remainder comes from the single generator
+    for (; i < count; i++)
+        values[i] = min + (float) (next() >> 8) * scale;
+}
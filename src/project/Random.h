@@ -0,0 +1,85 @@
+#ifndef PPGSO_RANDOM_H
+#define PPGSO_RANDOM_H
+
+#include <cstddef>
+#include <cstdint>
+
+/*!
+ * Small seeded random number generator owned by each emitter
+ * Based on xoshiro128+, single values come from one generator and batches from four interleaved ones,
+ * which are advanced together with SSE when the target supports it
+ * Unlike rand() it has no hidden global state, so emitters are reproducible from their seed
+ * and can be used from different threads
+ */
+class Random {
+public:
+    /*!
+     * Create a generator
+     * @param seed - Seed of the generated sequence, equal seeds give equal sequences
+     */
+    explicit Random(uint64_t seed = nextSeed());
+
+    /*!
+     * Get the next seed of a process-wide sequence starting from the base seed
+     * Emitters created in the same order therefore get the same seeds on every run
+     * @return Seed for a new generator
+     */
+    static uint64_t nextSeed();
+
+    /*!
+     * Derive a seed from the base seed and a stable key, independent of the order generators are created in
+     * @param key - Identity of the owner, e.g. its record index in the scene description
+     * @return Seed for a new generator, equal keys give equal seeds for the same base
+     */
+    static uint64_t seedFor(uint64_t key);
+
+    /*!
+     * Change the base seed and restart the sequence of nextSeed
+     * @param base - New base seed, runs with the same base get the same seeds
+     */
+    static void setSeedBase(uint64_t base);
+
+    /*!
+     * Generate random bits
+     * @return Uniformly distributed 32 bit value
+     */
+    uint32_t next();
+
+    /*!
+     * Generate a random float
+     * @return Value uniformly distributed in [0, 1)
+     */
+    float uniform();
+
+    /*!
+     * Generate a random float in range
+     * @param min - Lower bound
+     * @param max - Upper bound
+     * @return Value uniformly distributed between min and max
+     */
+    float range(float min, float max);
+
+    /*!
+     * Generate a random integer in range, replacement for rand() % (max - min) + min
+     * @param min - Lower bound, inclusive
+     * @param max - Upper bound, exclusive
+     * @return Value uniformly distributed in [min, max), min when the range is empty
+     */
+    int range(int min, int max);
+
+    /*!
+     * Fill a buffer with random floats
+     * @param values - Buffer to fill
+     * @param count - Number of values to generate
+     * @param min - Lower bound
+     * @param max - Upper bound
+     */
+    void fill(float *values, size_t count, float min = 0.0f, float max = 1.0f);
+
+private:
+    uint32_t state[4];
+    // Four generators for batches, lanes[word][generator] so one word of all generators is contiguous
+    alignas(16) uint32_t lanes[4][4];
+};
+
+#endif //PPGSO_RANDOM_H
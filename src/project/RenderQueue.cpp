@@ -0,0 +1,128 @@
+#include <cstring>
+
+#include "RenderQueue.h"
+#include "Object.h"
+
+namespace {
+    // Widths of the key fields, the pass always takes the two highest bits
+    const int SHADER_BITS = 10;
+    const int TEXTURE_BITS = 12;
+    const int MESH_BITS = 12;
+    const int DEPTH_BITS = 24;
+    const int PASS_SHIFT = 62;
+
+    /*!
+     * Quantize a distance for the key
+     * Bit patterns of positive floats are ordered the same as their values, the highest bits are kept
+     */
+    uint64_t depthBits(float distance) {
+        uint32_t bits;
+        std::memcpy(&bits, &distance, sizeof(bits));
+        return bits >> (32 - DEPTH_BITS);
+    }
+}
+
+void RenderQueue::begin(const glm::vec3 &viewPosition) {
+    this->viewPosition = viewPosition;
+    keys.clear();
+    packets.clear();
+    changes = 0;
+    // Ids only have to group equal resources within a frame, renumbering keeps them dense as resources come and go
+    ids.clear();
+}
+
+void RenderQueue::submit(Pass pass, Object &object, const ppgso::Shader &shader, const ppgso::Texture *texture, const ppgso::Mesh *mesh) {
+    auto depth = depthBits(glm::length(glm::vec3(object.modelMatrix[3]) - viewPosition));
+    auto shaderId = resourceId(&shader, SHADER_BITS);
+    auto textureId = resourceId(texture, TEXTURE_BITS);
+    auto meshId = resourceId(mesh, MESH_BITS);
+
+    uint64_t key = (uint64_t) pass << PASS_SHIFT;
+    if (pass == OPAQUE) {
+        // State first, nearest first within equal state so the depth test rejects hidden fragments early
+        key |= shaderId << (TEXTURE_BITS + MESH_BITS + DEPTH_BITS);
+        key |= textureId << (MESH_BITS + DEPTH_BITS);
+        key |= meshId << DEPTH_BITS;
+        key |= depth;
+    } else {
+        // Farthest first so blending composes correctly, state only breaks ties
+        auto inverseDepth = ~depth & ((1ull << DEPTH_BITS) - 1);
+        key |= inverseDepth << (SHADER_BITS + TEXTURE_BITS + MESH_BITS);
+        key |= shaderId << (TEXTURE_BITS + MESH_BITS);
+        key |= textureId << MESH_BITS;
+        key |= meshId;
+    }
+
+    keys.push_back(key);
+    packets.push_back({&object, &shader, texture});
+}
+
+void RenderQueue::execute(Scene &scene, Pass pass) {
+    order.clear();
+    sortedKeys.clear();
+    for (uint32_t i = 0; i < keys.size(); i++) {
+        if ((keys[i] >> PASS_SHIFT) != (uint64_t) pass) continue;
+        order.push_back(i);
+        sortedKeys.push_back(keys[i]);
+    }
+    sort(sortedKeys, order, scratchKeys, scratch);
+
+    // State may have been changed by draws outside of the queue, so the first packet always binds
+    const ppgso::Shader *currentShader = nullptr;
+    const ppgso::Texture *currentTexture = nullptr;
+    for (auto index : order) {
+        auto &packet = packets[index];
+        if (packet.shader != currentShader) {
+            packet.shader->use();
+            currentShader = packet.shader;
+            changes++;
+        }
+        if (packet.texture != nullptr && packet.texture != currentTexture) {
+            packet.texture->bind(0);
+            currentTexture = packet.texture;
+            changes++;
+        }
+        packet.object->draw(scene);
+    }
+}
+
+size_t RenderQueue::stateChanges() const {
+    return changes;
+}
+
+uint64_t RenderQueue::resourceId(const void *resource, int bits) {
+    if (resource == nullptr) return 0;
+    auto entry = ids.find(resource);
+    if (entry == ids.end())
+        entry = ids.emplace(resource, ids.size() + 1).first;
+    // Ids beyond the field width wrap around, which only makes the grouping less tight
+    // That takes more distinct shaders, textures and meshes in one frame than the field holds
+    return entry->second & ((1ull << bits) - 1);
+}
+
+void RenderQueue::sort(std::vector<uint64_t> &keys, std::vector<uint32_t> &order,
+                       std::vector<uint64_t> &scratchKeys, std::vector<uint32_t> &scratch) {
+    size_t count = order.size();
+    if (count < 2) return;
+    scratch.resize(count);
+    scratchKeys.resize(count);
+
+    for (int shift = 0; shift < 64; shift += 8) {
+        size_t offsets[257] = {};
+        for (auto key : keys)
+            offsets[((key >> shift) & 0xFF) + 1]++;
+
+        // A byte shared by all keys does not change the order
+        if (offsets[((keys[0] >> shift) & 0xFF) + 1] == count) continue;
+
+        for (int digit = 1; digit < 257; digit++)
+            offsets[digit] += offsets[digit - 1];
+        for (size_t i = 0; i < count; i++) {
+            auto target = offsets[(keys[i] >> shift) & 0xFF]++;
+            scratchKeys[target] = keys[i];
+            scratch[target] = order[i];
+        }
+        keys.swap(scratchKeys);
+        order.swap(scratch);
+    }
+}
@@ -0,0 +1,97 @@
+#ifndef PPGSO_RENDERQUEUE_H
+#define PPGSO_RENDERQUEUE_H
+
+#include <cstddef>
+#include <cstdint>
+#include <unordered_map>
+#include <vector>
+
+#include <glm/glm.hpp>
+#include <ppgso/ppgso.h>
+
+// Forward declare
+class Object;
+class Scene;
+
+/*!
+ * Draw packets collected during Scene::render and submitted in an order that minimizes GPU state changes
+ * Every packet has a 64 bit sort key built from its pass, shader, texture, mesh and distance to the camera
+ * Opaque packets are grouped by shader, texture and mesh and drawn front to back within a group,
+ * blended packets are drawn back to front regardless of their state
+ * Keys are sorted with a radix sort, the program and texture of a packet are only bound when they differ
+ * from the previous packet, so objects only set their own uniforms and issue the draw
+ */
+class RenderQueue {
+public:
+    enum Pass {
+        OPAQUE = 0,
+        BLENDED = 1
+    };
+
+    /*!
+     * Start a new frame, packets of the previous frame are dropped
+     * @param viewPosition - Camera position the packet depths are measured from
+     */
+    void begin(const glm::vec3 &viewPosition);
+
+    /*!
+     * Queue an object for drawing, Object::draw is called once its packet is executed
+     * @param pass - Pass the object is drawn in
+     * @param object - Object to draw, its modelMatrix gives the depth of the packet
+     * @param shader - Program the object draws with
+     * @param texture - Texture bound to unit 0 for the draw, nullptr if the shader does not sample one
+     * @param mesh - Mesh the object draws, only used to group equal draws together
+     */
+    void submit(Pass pass, Object &object, const ppgso::Shader &shader, const ppgso::Texture *texture, const ppgso::Mesh *mesh);
+
+    /*!
+     * Sort and draw all packets of a pass
+     * @param scene - Scene passed on to Object::draw
+     * @param pass - Pass to draw
+     */
+    void execute(Scene &scene, Pass pass);
+
+    /*!
+     * Get number of program and texture binds made since begin
+     * @return Number of state changes
+     */
+    size_t stateChanges() const;
+
+    /*!
+     * Radix sort keys together with their indices, least significant byte first, equal keys keep their order
+     * @param keys - Keys to sort in place
+     * @param order - Indices moved along with the keys
+     * @param scratchKeys - Scratch space for the keys, resized as needed
+     * @param scratch - Scratch space for the indices, resized as needed
+     */
+    static void sort(std::vector<uint64_t> &keys, std::vector<uint32_t> &order,
+                     std::vector<uint64_t> &scratchKeys, std::vector<uint32_t> &scratch);
+
+private:
+    struct Packet {
+        Object *object;
+        const ppgso::Shader *shader;
+        const ppgso::Texture *texture;
+    };
+
+    /*!
+     * Get a small number for a resource, used as its part of the sort key
+     * Numbers are handed out per frame, so streamed and released resources do not use up the field
+     * @param resource - Shader, texture or mesh
+     * @param bits - Width of the field in the key
+     * @return Number that fits the field, equal for equal resources
+     */
+    uint64_t resourceId(const void *resource, int bits);
+
+    glm::vec3 viewPosition;
+    std::vector<uint64_t> keys;
+    std::vector<Packet> packets;
+    // Sorted packet indices and the scratch space of the radix sort
+    std::vector<uint32_t> order, scratch;
+    std::vector<uint64_t> sortedKeys, scratchKeys;
+    // Ids of the resources submitted since begin, in order of their first packet
+    std::unordered_map<const void *, uint64_t> ids;
+    size_t changes = 0;
+};
+
+#endif //PPGSO_RENDERQUEUE_H
@@ -0,0 +1,45 @@
+#include "ResourceCache.h"
+#include "AssetLoader.h"
+#include "SceneUniforms.h"
+
+ResourceCache::Cache<ppgso::Mesh> ResourceCache::meshes;
+ResourceCache::Cache<ppgso::Texture> ResourceCache::textures;
+ResourceCache::Cache<ppgso::Shader> ResourceCache::shaders;
+
+std::shared_ptr<ppgso::Mesh> ResourceCache::mesh(const std::string &objFile) {
+    auto &entry = meshes[objFile];
+    auto mesh = entry.lock();
+    if (!mesh) {
+        // Start empty, the geometry is decoded in the background and uploaded by the AssetLoader
+        mesh = std::make_shared<ppgso::Mesh>();
+        entry = mesh;
+        AssetLoader::instance().loadMesh(mesh, objFile);
+    }
+    return mesh;
+}
+
+std::shared_ptr<ppgso::Texture> ResourceCache::texture(const std::string &bmpFile) {
+    auto &entry = textures[bmpFile];
+    auto texture = entry.lock();
+    if (!texture) {
+        // Use a single pixel placeholder until the image is decoded and uploaded by the AssetLoader
+        texture = std::make_shared<ppgso::Texture>(1, 1);
+        entry = texture;
+        AssetLoader::instance().loadTexture(texture, bmpFile);
+    }
+    return texture;
+}
+
+std::shared_ptr<ppgso::Shader> ResourceCache::shader(const std::string &vertexShaderCode, const std::string &fragmentShaderCode) {
+    // Sources are separated by a character that can not appear in GLSL code
+    auto &entry = shaders[vertexShaderCode + '\0' + fragmentShaderCode];
+    auto shader = entry.lock();
+    if (!shader) {
+        shader = std::make_shared<ppgso::Shader>(vertexShaderCode, fragmentShaderCode);
+        // Connect the per-frame camera and light data written by the Scene
+        shader->bindUniformBlock("Camera", SceneUniforms::CAMERA_BINDING);
+        shader->bindUniformBlock("SceneLights", SceneUniforms::LIGHTS_BINDING);
+        entry = shader;
+    }
+    return shader;
+}
@@ -0,0 +1,51 @@
+#ifndef PPGSO_RESOURCECACHE_H
+#define PPGSO_RESOURCECACHE_H
+
+#include <map>
+#include <memory>
+#include <string>
+
+#include <ppgso/ppgso.h>
+
+/*!
+ * Process-wide cache of GPU resources shared between scene objects
+ * Meshes and textures are keyed by their file path, shaders by their vertex and fragment source
+ * The returned handles are reference counted, a resource is released once the last handle goes away
+ * and loaded again on the next request
+ * Meshes and textures are returned right away and filled in asynchronously by the AssetLoader
+ * Shaders get their per-frame uniform blocks connected to the buffers written by the Scene
+ */
+class ResourceCache {
+public:
+    /*!
+     * Get a mesh loaded from a Wavefront .obj file
+     * @param objFile - File path to the obj file
+     * @return Shared handle to the mesh
+     */
+    static std::shared_ptr<ppgso::Mesh> mesh(const std::string &objFile);
+
+    /*!
+     * Get a texture loaded from a BMP image
+     * @param bmpFile - File path to the bmp file
+     * @return Shared handle to the texture
+     */
+    static std::shared_ptr<ppgso::Texture> texture(const std::string &bmpFile);
+
+    /*!
+     * Get a shader program compiled from the given sources
+     * @param vertexShaderCode - Source of the vertex shader
+     * @param fragmentShaderCode - Source of the fragment shader
+     * @return Shared handle to the shader program
+     */
+    static std::shared_ptr<ppgso::Shader> shader(const std::string &vertexShaderCode, const std::string &fragmentShaderCode);
+
+private:
+    template<typename T>
+    using Cache = std::map<std::string, std::weak_ptr<T>>;
+
+    static Cache<ppgso::Mesh> meshes;
+    static Cache<ppgso::Texture> textures;
+    static Cache<ppgso::Shader> shaders;
+};
+
+#endif //PPGSO_RESOURCECACHE_H
@@ -2,27 +2,250 @@
 // Created by madre on 16/11/2022.
 //
 
+#include <algorithm>
+#include <cmath>
+
 #include "Scene.h"
+#include "JobSystem.h"
+#include "SceneUniforms.h"
 
+namespace {
+    /*!
+     * Get the bounding sphere of an object in world space
+     * The sphere is scaled by the largest axis of the model matrix so it still encloses the geometry
+     */
+    bool worldBounds(const Object &object, glm::vec3 &center, float &radius) {
+        if (!object.getBounds(center, radius)) return false;
+        auto &m = object.modelMatrix;
+        center = glm::vec3(m * glm::vec4(center, 1.0f));
+        radius *= std::sqrt(std::max({glm::dot(glm::vec3(m[0]), glm::vec3(m[0])),
+                                      glm::dot(glm::vec3(m[1]), glm::vec3(m[1])),
+                                      glm::dot(glm::vec3(m[2]), glm::vec3(m[2]))}));
+        return true;
+    }
+}
 
 void Scene::update(float time) {
     camera->update();
 
-    // Use iterator to update all objects so we can remove while iterating
-    auto i = std::begin(*objects);
+    // The container does not change while updating, objects queue their spawns and removals instead
+    parallelObjects.clear();
+    serialObjects.clear();
+    for (auto &obj : *objects)
+        (obj->parallelUpdate() ? parallelObjects : serialObjects).push_back(obj.get());
 
-    while (i != std::end(*objects)) {
-        // Update and remove from list if needed
-        auto obj = i->get();
+    // Simulation of independent objects, each job writes only its own objects and results
+    keep.resize(parallelObjects.size());
+    JobSystem::instance().parallelFor(parallelObjects.size(), UPDATE_GRAIN, [this, time](size_t begin, size_t end) {
+        for (size_t i = begin; i < end; i++)
+            keep[i] = parallelObjects[i]->update(*this, time) ? 1 : 0;
+    });
+    for (size_t i = 0; i < parallelObjects.size(); i++) {
+        if (!keep[i])
+            destroyed.push_back(parallelObjects[i]);
+    }
+
+    // Objects that change other objects or shared systems
+    for (auto obj : serialObjects) {
         if (!obj->update(*this, time))
-            i = objects->erase(i); // NOTE: no need to call destructors as we store shared pointers in the scene
-        else
-            ++i;
+            destroyed.push_back(obj);
     }
+
+    projectiles.update(time);
+
+    applyCommands();
+    transforms.update(*objects);
+    refitBounds();
+}
+
+void Scene::spawn(std::unique_ptr<Object> object) {
+    std::lock_guard<std::mutex> lock(commandsMutex);
+    spawned.push_back(std::move(object));
+}
+
+void Scene::destroy(Object *object) {
+    std::lock_guard<std::mutex> lock(commandsMutex);
+    destroyed.push_back(object);
+}
+
+void Scene::applyCommands() {
+    if (!destroyed.empty()) {
+        // Collect the handles first, erasing moves objects around in the packed storage
+        std::sort(destroyed.begin(), destroyed.end());
+        std::vector<SlotHandle<Object>> handles;
+        for (size_t i = 0; i < objects->size(); i++) {
+            if (std::binary_search(destroyed.begin(), destroyed.end(), (objects->begin() + i)->get()))
+                handles.push_back(objects->handleAt(i));
+        }
+        for (auto &handle : handles)
+            objects->erase(handle);
+        destroyed.clear();
+    }
+
+    for (auto &obj : spawned)
+        objects->insert(std::move(obj));
+    spawned.clear();
+}
+
+void Scene::render(float alpha) {
+    // Transitions move the camera on simulation ticks, frames in between show it part of the way like the objects,
+    // the camera is also looked around with every frame, not only on ticks
+    auto position = camera->position;
+    auto lookAtPos = camera->lookAtPos;
+    camera->position = glm::mix(camera->previousPosition, position, alpha);
+    camera->lookAtPos = glm::mix(camera->previousLookAtPos, lookAtPos, alpha);
+    camera->updateViewMatrix();
+    uploadUniforms();
+
+    // The scene may have been switched since the last update
+    syncBounds();
+
+    frustum.extract(camera->projectionMatrix * camera->viewMatrix);
+    visible.assign(unbounded.begin(), unbounded.end());
+    bvh.query(frustum, visible);
+
+    // Visited front to back through the packed storage, draw order does not depend on it, the queue and the
+    // instanced renderer order their draws by state and the few objects that draw right away are opaque and depth tested
+    std::sort(visible.begin(), visible.end());
+    transforms.interpolate(*objects, alpha);
+    queue.begin(camera->position);
+    auto first = objects->begin();
+    for (auto position : visible)
+        (first + position)->get()->render(*this);
+
+    queue.execute(*this, RenderQueue::OPAQUE);
+    instances.flush();
+    projectiles.render();
+    queue.execute(*this, RenderQueue::BLENDED);
+    transforms.restore();
+    camera->position = position;
+    camera->lookAtPos = lookAtPos;
+}
+
+std::vector<Object*> Scene::intersect(const glm::vec3 &position, const glm::vec3 &direction) {
+    syncBounds();
+
+    std::vector<uint32_t> ids;
+    bvh.raycast(position, direction, ids);
+
+    std::vector<Object*> picked;
+    for (auto id : ids)
+        picked.push_back((objects->begin() + id)->get());
+    return picked;
 }
 
-void Scene::render() {
-    // Simply render all objects
-    for ( auto& obj : (*objects) )
-        obj->render(*this);
-}
\ No newline at end of file
+std::vector<Object*> Scene::overlaps(const glm::vec3 &min, const glm::vec3 &max) {
+    syncBounds();
+
+    std::vector<uint32_t> ids;
+    bvh.overlaps(min, max, ids);
+
+    std::vector<Object*> found;
+    for (auto id : ids)
+        found.push_back((objects->begin() + id)->get());
+    return found;
+}
+
+bool Scene::syncBounds() {
+    if (boundsObjects == objects && boundsRevision == objects->revision())
+        return false;
+    rebuildBounds();
+    return true;
+}
+
+void Scene::rebuildBounds() {
+    // Leaves of another scene are of no use
+    if (boundsObjects != objects) {
+        bvh.clear();
+        proxies.clear();
+    }
+
+    // Leaves of objects that are still present are moved over, the ones left behind belong to removed objects
+    std::unordered_map<Object *, int32_t> kept;
+    unbounded.clear();
+    glm::vec3 center;
+    float radius;
+    uint32_t position = 0;
+    for (auto &obj : *objects) {
+        if (!worldBounds(*obj, center, radius)) {
+            unbounded.push_back(position++);
+            continue;
+        }
+
+        auto proxy = proxies.find(obj.get());
+        if (proxy == proxies.end()) {
+            kept[obj.get()] = bvh.insert(position, center, radius);
+        } else {
+            bvh.move(proxy->second, center, radius);
+            bvh.setId(proxy->second, position);
+            kept[obj.get()] = proxy->second;
+            proxies.erase(proxy);
+        }
+        position++;
+    }
+    for (auto &proxy : proxies)
+        bvh.remove(proxy.second);
+    proxies = std::move(kept);
+
+    boundsObjects = objects;
+    boundsRevision = objects->revision();
+}
+
+void Scene::refitBounds() {
+    // Adding or removing objects changes the packed positions, so every leaf is visited anyway
+    if (syncBounds()) return;
+
+    glm::vec3 center;
+    float radius;
+    for (auto obj : transforms.changed()) {
+        auto proxy = proxies.find(obj);
+        if (proxy != proxies.end() && worldBounds(*obj, center, radius))
+            bvh.move(proxy->second, center, radius);
+    }
+
+    // Meshes are loaded in the background, their objects get bounds once the geometry is uploaded
+    auto first = objects->begin();
+    for (size_t i = 0; i < unbounded.size();) {
+        auto obj = (first + unbounded[i])->get();
+        if (worldBounds(*obj, center, radius)) {
+            proxies[obj] = bvh.insert(unbounded[i], center, radius);
+            unbounded[i] = unbounded.back();
+            unbounded.pop_back();
+        } else {
+            i++;
+        }
+    }
+}
+
+void Scene::uploadUniforms() {
+    if (!cameraBuffer) {
+        cameraBuffer = std::make_unique<ppgso::UniformBuffer>(SceneUniforms::CAMERA_BINDING, sizeof(SceneUniforms::CameraBlock));
+        lightsBuffer = std::make_unique<ppgso::UniformBuffer>(SceneUniforms::LIGHTS_BINDING, sizeof(SceneUniforms::LightsBlock));
+    }
+
+    SceneUniforms::CameraBlock cameraBlock = {};
+    cameraBlock.projectionMatrix = camera->projectionMatrix;
+    cameraBlock.viewMatrix = camera->viewMatrix;
+    cameraBlock.viewPosition = camera->position;
+    cameraBlock.lightDirection = lightDirection;
+    cameraBuffer->update(cameraBlock);
+
+    // Unused entries stay zeroed so they do not contribute any light
+    SceneUniforms::LightsBlock lightsBlock = {};
+    int i = 0;
+    for (auto &light : *lights) {
+        // The shader has no room for more lights
+        if (i == SceneUniforms::MAX_LIGHTS) break;
+        auto &data = lightsBlock.lights[i];
+        data.type = light->type;
+        data.position = light->position;
+        data.color = light->color;
+        data.brightness = light->brightness;
+        if (light->type == 1)
+            data.direction = light->direction;
+        i++;
+    }
+    // Only the uploaded entries are counted, the shader loop would read past the array otherwise
+    lightsBlock.count = (float) std::min(lights->size(), (size_t) SceneUniforms::MAX_LIGHTS);
+    lightsBuffer->update(lightsBlock);
+}
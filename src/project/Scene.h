@@ -4,45 +4,102 @@
 #include <memory>
 #include <map>
 #include <list>
+#include <mutex>
+#include <unordered_map>
+#include <vector>
 
 #include "Object.h"
+#include "BoundingVolumeHierarchy.h"
 #include "Camera.h"
+#include "Frustum.h"
 #include "LightSource.h"
+#include "InstancedRenderer.h"
+#include "RenderQueue.h"
+#include "TransformSystem.h"
+#include "objects/ProjectileSystem.h"
 
 /*
  * Scene is an object that will aggregate all scene related data
- * Objects are stored in a list of objects
+ * Objects and lights are stored in slot maps owned by the active GeneralScene
  * Keyboard and Mouse states are stored in a map and struct
  */
 class Scene {
 public:
     /*!
      * Update all objects in the scene
+     * Objects with Object::parallelUpdate are simulated first, spread over the JobSystem,
+     * the remaining objects are updated one by one on the calling thread after them
+     * Spawn and destroy requests made during the update are applied in one batch at the end,
+     * then the model matrices of moved objects are rebuilt together and their bounds are refit
      * @param time
      */
     void update(float time);
 
+    /*!
+     * Request adding an object to the scene, it is added after the current update and updated from the next one
+     * Safe to call from parallel updates
+     * @param object - Object to add
+     */
+    void spawn(std::unique_ptr<Object> object);
+
+    /*!
+     * Request removing an object from the scene after the current update
+     * Objects can also remove themselves by returning false from Object::update
+     * Safe to call from parallel updates
+     * @param object - Object to remove
+     */
+    void destroy(Object *object);
+
     /*!
      * Render all objects in the scene
+     * Camera and light data are uploaded into the shared uniform buffers first
+     * Objects whose bounding sphere is outside of the camera view are skipped,
+     * the visible ones are found with the bounding volume hierarchy and visited in storage order, which is not the order
+     * they were added in, removing an object moves the last one into its place
+     * Objects moved by the last update are drawn between their previous and current transform
+     * Objects queue their draws into the RenderQueue, opaque packets are drawn sorted by state,
+     * then Model copies with instancing and the pooled projectiles, blended packets are drawn last
+     * @param alpha - Part of a simulation tick elapsed since the last update, 1 draws the simulated state
      */
-    void render();
+    void render(float alpha = 1.0f);
 
     /*!
      * Pick objects using a ray
+     * Only objects with bounds can be hit, objects whose mesh is still loading are skipped
      * @param position - Position in the scene to pick object from
-     * @param direction - Direction to pick objects from
-     * @return Objects - Vector of pointers to intersected objects
+     * @param direction - Normalized direction to pick objects from
+     * @return Objects - Vector of pointers to intersected objects, nearest first
+     */
+    std::vector<Object*> intersect(const glm::vec3 &position, const glm::vec3 &direction);
+
+    /*!
+     * Find objects whose bounding sphere overlaps a box
+     * @param min - Minimum corner of the box in world space
+     * @param max - Maximum corner of the box in world space
+     * @return Objects - Vector of pointers to overlapping objects
      */
-    //std::vector<Object*> intersect(const glm::vec3 &position, const glm::vec3 &direction);
+    std::vector<Object*> overlaps(const glm::vec3 &min, const glm::vec3 &max);
 
     // Camera object
     std::unique_ptr<Camera> camera;
 
     // All objects to be rendered in scene
-    std::list< std::unique_ptr<Object> >* objects;
+    SceneObjects* objects;
 
     // All lights to be calculated in shader
-    std::list< std::unique_ptr<LightSource> >* lights;
+    SceneLights* lights;
+
+    // Rebuilds model matrices of objects that moved
+    TransformSystem transforms;
+
+    // Batches copies of the same Model into instanced draw calls
+    InstancedRenderer instances;
+
+    // Draws of the other objects, sorted to avoid program and texture switches
+    RenderQueue queue;
+
+    // Pooled thrown bottles and their splashes
+    ProjectileSystem projectiles;
 
     // Keyboard state
     std::map< int, int > keyboard;
@@ -55,6 +112,63 @@ public:
         double x, y;
         bool left, right;
     } cursor;
+
+private:
+    /*!
+     * Rebuild the leaves of the bounding volume hierarchy if objects were added, removed or switched
+     * @return true if the leaves were rebuilt
+     */
+    bool syncBounds();
+
+    /*!
+     * Match the leaves of the bounding volume hierarchy to the current objects,
+     * leaves of objects still in the scene are kept and only get their packed position updated
+     */
+    void rebuildBounds();
+
+    /*!
+     * Refit the leaves of objects moved by the last transform update
+     * and add objects whose bounds became known since the last frame
+     */
+    void refitBounds();
+
+    Frustum frustum;
+    // Leaves carry the packed positions of their objects as ids
+    BoundingVolumeHierarchy bvh;
+    std::unordered_map<Object *, int32_t> proxies;
+    // Packed positions of objects without bounds, they are never culled
+    std::vector<uint32_t> unbounded;
+    // Container and revision the leaves were built for
+    const SceneObjects *boundsObjects = nullptr;
+    size_t boundsRevision = 0;
+    std::vector<uint32_t> visible;
+
+    /*!
+     * Apply queued spawn and destroy requests
+     */
+    void applyCommands();
+
+    // Requests collected during update, guarded by commandsMutex while objects update in parallel
+    std::mutex commandsMutex;
+    std::vector<std::unique_ptr<Object>> spawned;
+    std::vector<Object *> destroyed;
+
+    // Objects updated by one job, most updates are cheap so they are handed out in groups
+    static constexpr size_t UPDATE_GRAIN = 16;
+
+    // Objects of the current update split by Object::parallelUpdate, and the results of the parallel ones
+    std::vector<Object *> parallelObjects;
+    std::vector<Object *> serialObjects;
+    std::vector<uint8_t> keep;
+
+    /*!
+     * Write camera and lights into the per-frame uniform buffers
+     */
+    void uploadUniforms();
+
+    // Per-frame uniform buffers, created on first render when the OpenGL context exists
+    std::unique_ptr<ppgso::UniformBuffer> cameraBuffer;
+    std::unique_ptr<ppgso::UniformBuffer> lightsBuffer;
 };
 
 #endif // _PPGSO_SCENE_H
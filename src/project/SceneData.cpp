@@ -0,0 +1,435 @@
+#include <algorithm>
+#include <cstring>
+#include <fstream>
+#include <map>
+#include <sstream>
+#include <stdexcept>
+#include <type_traits>
+
+#include <glm/glm.hpp>
+#include <ppgso/mesh_data.h>
+
+#include "SceneData.h"
+
+namespace {
+    const char SCENE_MAGIC[4] = {'P', 'S', 'C', 'N'};
+    const uint32_t SCENE_VERSION = 3;
+    const uint64_t SCENE_ALIGNMENT = 16;
+
+    // Tables in the order they are stored
+    enum TableIndex {
+        STRINGS, NODES, BATCHES, INSTANCES, CHARACTERS, LAMPS, LIGHTS, EMITTERS, SPAWNS, CAMERAS, STREAMING, TABLE_COUNT
+    };
+
+    struct Header {
+        char magic[4];
+        uint32_t version;
+        uint64_t offsets[TABLE_COUNT];
+        uint32_t counts[TABLE_COUNT];
+    };
+
+    uint64_t align(uint64_t offset) {
+        return (offset + SCENE_ALIGNMENT - 1) / SCENE_ALIGNMENT * SCENE_ALIGNMENT;
+    }
+
+    [[noreturn]] void fail(const std::string &message, const std::string &file) {
+        std::stringstream msg;
+        msg << message << " " << file;
+        throw std::runtime_error(msg.str());
+    }
+
+    /*!
+     * State of the text parser while reading one file
+     */
+    struct Parser {
+        std::string file;
+        int line = 0;
+        std::istringstream tokens;
+        std::map<std::string, uint32_t> interned;
+        std::map<std::string, uint32_t> nodeIndices;
+
+        [[noreturn]] void error(const std::string &message) {
+            std::stringstream msg;
+            msg << message << " at " << file << ":" << line;
+            throw std::runtime_error(msg.str());
+        }
+
+        std::string word(const std::string &what) {
+            std::string value;
+            if (!(tokens >> value)) error("Missing " + what);
+            return value;
+        }
+
+        void numbers(float *values, int count, const std::string &attribute) {
+            for (int i = 0; i < count; i++)
+                if (!(tokens >> values[i])) error("Expected " + std::to_string(count) + " numbers after " + attribute);
+        }
+
+        uint32_t intern(std::string &blob, const std::string &value) {
+            auto entry = interned.find(value);
+            if (entry != interned.end()) return entry->second;
+            auto offset = (uint32_t) blob.size();
+            blob.append(value).push_back('\0');
+            interned.emplace(value, offset);
+            return offset;
+        }
+    };
+
+    void setVector(float *target, float x, float y, float z) {
+        target[0] = x;
+        target[1] = y;
+        target[2] = z;
+    }
+}
+
+SceneData SceneData::load(const std::string &file) {
+    auto compiled = binaryPath(file);
+    if (ppgso::MappedFile::exists(compiled))
+        return loadBinary(compiled);
+    return loadText(file);
+}
+
+std::string SceneData::binaryPath(const std::string &file) {
+    auto extension = file.find_last_of('.');
+    auto separator = file.find_last_of("/\\");
+    if (extension == std::string::npos || (separator != std::string::npos && extension < separator))
+        return file + ".scn";
+    return file.substr(0, extension) + ".scn";
+}
+
+std::string SceneData::string(uint32_t offset) const {
+    if (offset == NONE) return "";
+    if (offset >= strings.count) throw std::runtime_error("Scene string offset out of range");
+    return std::string(strings.records + offset);
+}
+
+SceneData SceneData::loadText(const std::string &file) {
+    std::ifstream input(file);
+    if (!input.is_open())
+        fail("Could not open scene file.", file);
+
+    SceneData data;
+    data.storage = std::unique_ptr<Storage>(new Storage());
+    auto &store = *data.storage;
+
+    // Instances are collected in declaration order and grouped once the whole file is read
+    std::vector<std::pair<std::pair<uint32_t, uint32_t>, Instance>> models;
+
+    Parser parser;
+    parser.file = file;
+    std::string text;
+    while (std::getline(input, text)) {
+        parser.line++;
+        auto comment = text.find('#');
+        if (comment != std::string::npos) text.erase(comment);
+        parser.tokens.clear();
+        parser.tokens.str(text);
+
+        std::string record;
+        if (!(parser.tokens >> record)) continue;
+
+        if (record == "camera") {
+            Camera camera = {};
+            camera.name = parser.intern(store.strings, parser.word("camera preset name"));
+            std::string attribute;
+            while (parser.tokens >> attribute) {
+                if (attribute == "position") parser.numbers(camera.position, 3, attribute);
+                else if (attribute == "target") parser.numbers(camera.target, 3, attribute);
+                else parser.error("Unknown camera attribute " + attribute);
+            }
+            store.cameras.push_back(camera);
+            continue;
+        }
+
+        if (record == "streaming") {
+            if (!store.streaming.empty()) parser.error("Streaming is already set up");
+            Streaming streaming = {60, 100, 20, 2};
+            std::string attribute;
+            while (parser.tokens >> attribute) {
+                if (attribute == "cell") parser.numbers(&streaming.cellSize, 1, attribute);
+                else if (attribute == "radius") parser.numbers(&streaming.radius, 1, attribute);
+                else if (attribute == "margin") parser.numbers(&streaming.margin, 1, attribute);
+                else if (attribute == "lookahead") parser.numbers(&streaming.lookahead, 1, attribute);
+                else parser.error("Unknown streaming attribute " + attribute);
+            }
+            if (streaming.cellSize <= 0) parser.error("Streaming cells need a positive size");
+            store.streaming.push_back(streaming);
+            continue;
+        }
+
+        bool model = record == "model" || record == "floor";
+        bool light = record == "lamp" || record == "light";
+        bool emitter = record == "particles" || record == "drip" || record == "items";
+        if (!model && !light && !emitter && record != "node" && record != "steve")
+            parser.error("Unknown record " + record);
+
+        Transform transform = {};
+        transform.name = NONE;
+        transform.parent = NONE;
+        setVector(transform.scale, 1, 1, 1);
+
+        uint32_t mesh = NONE, texture = NONE;
+        if (model) {
+            mesh = parser.intern(store.strings, parser.word("mesh file"));
+            texture = parser.intern(store.strings, parser.word("texture file"));
+            if (record == "floor") transform.flags |= FLOOR;
+        }
+
+        Light lightRecord = {};
+        if (record == "light") {
+            auto type = parser.word("light type");
+            if (type != "point" && type != "spot") parser.error("Unknown light type " + type);
+            lightRecord.spot = type == "spot";
+        }
+        lightRecord.size = 1;
+        lightRecord.brightness = 1;
+        setVector(lightRecord.color, 1, 1, 1);
+        setVector(lightRecord.direction, 0, -1, 0);
+
+        float material[3] = {32, 1, 1};
+        Emitter emitterRecord = {};
+        emitterRecord.kind = record == "drip" ? DRIP : record == "items" ? ITEMS : PARTICLES;
+        emitterRecord.amount = 10000;
+        setVector(emitterRecord.velocity, 0, 3, 0);
+        emitterRecord.firstSpawn = (uint32_t) store.spawns.size();
+
+        std::string attribute;
+        while (parser.tokens >> attribute) {
+            if (attribute == "name") {
+                transform.name = parser.intern(store.strings, parser.word("name"));
+            } else if (attribute == "parent") {
+                auto parent = parser.nodeIndices.find(parser.word("parent node"));
+                if (parent == parser.nodeIndices.end()) parser.error("Parent has to be a node declared earlier");
+                transform.parent = parent->second;
+            } else if (attribute == "position") {
+                parser.numbers(transform.position, 3, attribute);
+            } else if (attribute == "rotation") {
+                parser.numbers(transform.rotation, 3, attribute);
+                for (auto &angle : transform.rotation) angle = glm::radians(angle);
+            } else if (attribute == "scale") {
+                parser.numbers(transform.scale, 3, attribute);
+            } else if (attribute == "static") {
+                transform.flags |= STATIC;
+            } else if (attribute == "resident") {
+                transform.flags |= RESIDENT;
+            } else if (attribute == "material" && model) {
+                parser.numbers(material, 3, attribute);
+            } else if (attribute == "size" && light) {
+                parser.numbers(&lightRecord.size, 1, attribute);
+            } else if (attribute == "color" && light) {
+                parser.numbers(lightRecord.color, 3, attribute);
+            } else if (attribute == "brightness" && light) {
+                parser.numbers(&lightRecord.brightness, 1, attribute);
+            } else if (attribute == "direction" && light) {
+                parser.numbers(lightRecord.direction, 3, attribute);
+            } else if (attribute == "amount" && record == "particles") {
+                float amount;
+                parser.numbers(&amount, 1, attribute);
+                emitterRecord.amount = (uint32_t) amount;
+            } else if (attribute == "velocity" && record == "drip") {
+                parser.numbers(emitterRecord.velocity, 3, attribute);
+            } else if (attribute == "bounce" && record == "drip") {
+                transform.flags |= BOUNCE;
+            } else if (attribute == "still" && record == "drip") {
+                transform.flags |= STILL;
+            } else if (attribute == "spawn" && record == "items") {
+                Spawn spawn;
+                parser.numbers(spawn.point, 4, attribute);
+                store.spawns.push_back(spawn);
+            } else {
+                parser.error("Unknown " + record + " attribute " + attribute);
+            }
+        }
+
+        if (record == "node") {
+            if (transform.name != NONE)
+                parser.nodeIndices[store.strings.c_str() + transform.name] = (uint32_t) store.nodes.size();
+            store.nodes.push_back(transform);
+        } else if (model) {
+            Instance instance = {};
+            instance.transform = transform;
+            std::copy(material, material + 3, instance.material);
+            models.push_back({{mesh, texture}, instance});
+        } else if (record == "steve") {
+            store.characters.push_back(transform);
+        } else if (light) {
+            lightRecord.transform = transform;
+            (record == "lamp" ? store.lamps : store.lights).push_back(lightRecord);
+        } else {
+            emitterRecord.transform = transform;
+            emitterRecord.spawnCount = (uint32_t) store.spawns.size() - emitterRecord.firstSpawn;
+            store.emitters.push_back(emitterRecord);
+        }
+    }
+
+    // Group instances sharing mesh and texture so each batch is one contiguous range
+    std::stable_sort(models.begin(), models.end(),
+                     [](const std::pair<std::pair<uint32_t, uint32_t>, Instance> &a,
+                        const std::pair<std::pair<uint32_t, uint32_t>, Instance> &b) {
+                         return a.first < b.first;
+                     });
+    for (auto &entry : models) {
+        if (store.batches.empty() || store.batches.back().mesh != entry.first.first ||
+            store.batches.back().texture != entry.first.second)
+            store.batches.push_back({entry.first.first, entry.first.second, (uint32_t) store.instances.size(), 0, 0});
+        store.batches.back().count++;
+        store.instances.push_back(entry.second);
+    }
+
+    data.view();
+    return data;
+}
+
+void SceneData::markBatchable(const std::string &directory) {
+    if (!storage) throw std::runtime_error("Only parsed scenes can be changed");
+
+    for (auto &batch : storage->batches) {
+        // Missing meshes are left to the runtime to report, their batches are drawn on their own
+        auto file = directory + string(batch.mesh);
+        if (!ppgso::MappedFile::exists(file) && !ppgso::MappedFile::exists(ppgso::MeshData::binaryPath(file)))
+            continue;
+
+        auto mesh = ppgso::MeshData::load(file);
+        uint32_t vertexCount = 0;
+        for (auto &shape : mesh.shapes)
+            vertexCount += shape.vertexCount;
+        if (vertexCount <= MAX_BATCHED_VERTICES)
+            batch.flags |= BATCHABLE;
+    }
+}
+
+void SceneData::view() {
+    auto point = [](const auto &vector, auto &table) {
+        table.records = vector.data();
+        table.count = (uint32_t) vector.size();
+    };
+    point(storage->strings, strings);
+    point(storage->nodes, nodes);
+    point(storage->batches, batches);
+    point(storage->instances, instances);
+    point(storage->characters, characters);
+    point(storage->lamps, lamps);
+    point(storage->lights, lights);
+    point(storage->emitters, emitters);
+    point(storage->spawns, spawns);
+    point(storage->cameras, cameras);
+    point(storage->streaming, streaming);
+}
+
+SceneData SceneData::loadBinary(const std::string &file) {
+    SceneData data;
+    data.mapping = std::unique_ptr<ppgso::MappedFile>(new ppgso::MappedFile(file));
+
+    auto bytes = data.mapping->data();
+    auto size = data.mapping->size();
+
+    if (size < sizeof(Header))
+        fail("Scene file is too small.", file);
+
+    Header header;
+    std::memcpy(&header, bytes, sizeof(Header));
+    if (std::memcmp(header.magic, SCENE_MAGIC, sizeof(SCENE_MAGIC)) != 0)
+        fail("Scene file does not contain supported scene format.", file);
+    if (header.version != SCENE_VERSION)
+        fail("Scene file has unsupported version.", file);
+
+    // Tables are aligned so the mapped memory can be used in place
+    auto point = [&](TableIndex index, auto &table) {
+        using Record = typename std::remove_reference<decltype(*table.records)>::type;
+        if (header.offsets[index] % SCENE_ALIGNMENT != 0 ||
+            header.offsets[index] + (uint64_t) header.counts[index] * sizeof(Record) > size)
+            fail("Scene file is truncated.", file);
+        table.records = reinterpret_cast<Record *>(bytes + header.offsets[index]);
+        table.count = header.counts[index];
+    };
+    point(STRINGS, data.strings);
+    point(NODES, data.nodes);
+    point(BATCHES, data.batches);
+    point(INSTANCES, data.instances);
+    point(CHARACTERS, data.characters);
+    point(LAMPS, data.lamps);
+    point(LIGHTS, data.lights);
+    point(EMITTERS, data.emitters);
+    point(SPAWNS, data.spawns);
+    point(CAMERAS, data.cameras);
+    point(STREAMING, data.streaming);
+
+    if (data.strings.count > 0 && data.strings[data.strings.count - 1] != '\0')
+        fail("Scene file has unterminated strings.", file);
+    for (auto &batch : data.batches)
+        if (batch.first + (uint64_t) batch.count > data.instances.count)
+            fail("Scene file has batches out of range.", file);
+    for (auto &emitter : data.emitters)
+        if (emitter.firstSpawn + (uint64_t) emitter.spawnCount > data.spawns.count)
+            fail("Scene file has spawn points out of range.", file);
+
+    // Parents have to be declared before the record, same as the text format requires,
+    // so walking up from any record ends and never leaves the node table
+    auto checkParent = [&](const Transform &transform, uint32_t limit) {
+        if (transform.parent != NONE && transform.parent >= limit)
+            fail("Scene file has parents out of range.", file);
+    };
+    for (uint32_t i = 0; i < data.nodes.count; i++)
+        checkParent(data.nodes[i], i);
+    for (auto &instance : data.instances)
+        checkParent(instance.transform, data.nodes.count);
+    for (auto &character : data.characters)
+        checkParent(character, data.nodes.count);
+    for (auto &lamp : data.lamps)
+        checkParent(lamp.transform, data.nodes.count);
+    for (auto &light : data.lights)
+        checkParent(light.transform, data.nodes.count);
+    for (auto &emitter : data.emitters)
+        checkParent(emitter.transform, data.nodes.count);
+
+    return data;
+}
+
+void SceneData::saveBinary(const std::string &file) const {
+    std::ofstream output(file, std::ios::binary);
+    if (!output.is_open())
+        fail("Could not open scene file.", file);
+
+    Header header = {};
+    std::memcpy(header.magic, SCENE_MAGIC, sizeof(SCENE_MAGIC));
+    header.version = SCENE_VERSION;
+
+    // Lay out the tables after the header
+    const void *blocks[TABLE_COUNT];
+    uint64_t sizes[TABLE_COUNT];
+    auto layout = [&](TableIndex index, const auto &table) {
+        blocks[index] = table.records;
+        sizes[index] = table.count * sizeof(*table.records);
+        header.counts[index] = table.count;
+    };
+    layout(STRINGS, strings);
+    layout(NODES, nodes);
+    layout(BATCHES, batches);
+    layout(INSTANCES, instances);
+    layout(CHARACTERS, characters);
+    layout(LAMPS, lamps);
+    layout(LIGHTS, lights);
+    layout(EMITTERS, emitters);
+    layout(SPAWNS, spawns);
+    layout(CAMERAS, cameras);
+    layout(STREAMING, streaming);
+
+    uint64_t offset = sizeof(Header);
+    for (int i = 0; i < TABLE_COUNT; i++) {
+        header.offsets[i] = offset = align(offset);
+        offset += sizes[i];
+    }
+
+    output.write((const char *) &header, sizeof(Header));
+
+    const char padding[SCENE_ALIGNMENT] = {};
+    uint64_t written = sizeof(Header);
+    for (int i = 0; i < TABLE_COUNT; i++) {
+        output.write(padding, header.offsets[i] - written);
+        output.write((const char *) blocks[i], sizes[i]);
+        written = header.offsets[i] + sizes[i];
+    }
+
+    if (!output)
+        fail("Failed to write scene file.", file);
+}
@@ -0,0 +1,216 @@
+#ifndef PPGSO_SCENEDATA_H
+#define PPGSO_SCENEDATA_H
+
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include <ppgso/mapped_file.h>
+
+/*!
+ * Declarative description of a scene, either parsed from a text .scene file or mapped from a compiled binary .scn file
+ *
+ * Text .scene format, one record per line, # starts a comment, angles are in degrees:
+ * camera <preset> position x y z target x y z
+ * streaming cell size radius distance margin distance lookahead seconds
+ * node, model <mesh> <texture>, floor <mesh> <texture>, steve, lamp, light point|spot, particles, drip, items
+ * followed by any of their attributes:
+ * name n, parent node, position x y z, rotation x y z, scale x y z, static, resident, material shininess diffuse specular,
+ * size s, color r g b, brightness b, direction x y z, amount n, velocity x y z, bounce, still, spawn x y z side
+ *
+ * Binary .scn layout (little endian, all tables 16 byte aligned):
+ * Header - magic "PSCN", version, offset and size of every table from file start
+ * Tables - string blob, nodes, batches, instances, characters, lamps, lights, emitters, spawn points, cameras, streaming
+ * Instances are sorted by mesh and texture, every batch lists the range of instances sharing both
+ * and is marked batchable when its mesh is small enough to merge
+ */
+class SceneData {
+public:
+    // Marks a missing string or parent
+    static const uint32_t NONE = 0xFFFFFFFF;
+
+    enum Flags : uint32_t {
+        STATIC = 1,
+        FLOOR = 2,
+        BOUNCE = 4,
+        STILL = 8,
+        // Never streamed out, for records looked up by name or scripted
+        RESIDENT = 16,
+        // Batch with a mesh small enough to be merged by the StaticBatcher, set by the scene compiler
+        BATCHABLE = 32
+    };
+
+    // Largest mesh of a batchable batch, in vertices, a cube has 24
+    static const uint32_t MAX_BATCHED_VERTICES = 1024;
+
+    // Placement shared by all records, the parent is an index into the node table declared before the record
+    struct Transform {
+        uint32_t name;
+        uint32_t parent;
+        uint32_t flags;
+        float position[3];
+        float rotation[3];
+        float scale[3];
+    };
+
+    // Mesh and texture are offsets into the string blob
+    struct Batch {
+        uint32_t mesh;
+        uint32_t texture;
+        uint32_t first;
+        uint32_t count;
+        uint32_t flags;
+    };
+
+    struct Instance {
+        Transform transform;
+        float material[3];
+    };
+
+    struct Light {
+        Transform transform;
+        uint32_t spot;
+        float size;
+        float color[3];
+        float brightness;
+        float direction[3];
+    };
+
+    enum EmitterKind : uint32_t {
+        PARTICLES = 0,
+        DRIP = 1,
+        ITEMS = 2
+    };
+
+    struct Emitter {
+        Transform transform;
+        uint32_t kind;
+        uint32_t amount;
+        float velocity[3];
+        uint32_t firstSpawn;
+        uint32_t spawnCount;
+    };
+
+    // x, y, z and the side the item is thrown from, 1 left and -1 right
+    struct Spawn {
+        float point[4];
+    };
+
+    struct Camera {
+        uint32_t name;
+        float position[3];
+        float target[3];
+    };
+
+    // Settings of the WorldStreamer, scenes without them are loaded whole
+    struct Streaming {
+        float cellSize;
+        float radius;
+        float margin;
+        float lookahead;
+    };
+
+    /*!
+     * View of one table, the records are owned by the SceneData
+     */
+    template<typename T>
+    struct Table {
+        const T *records = nullptr;
+        uint32_t count = 0;
+
+        const T *begin() const { return records; }
+        const T *end() const { return records + count; }
+        const T &operator[](size_t i) const { return records[i]; }
+    };
+
+    SceneData() = default;
+    SceneData(SceneData&&) = default;
+    SceneData &operator=(SceneData&&) = default;
+    SceneData(const SceneData&) = delete;
+    SceneData &operator=(const SceneData&) = delete;
+
+    /*!
+     * Load a scene, the compiled binary file next to the text file is preferred when it exists
+     * @param file - File path to the .scene file
+     * @return Loaded scene description
+     */
+    static SceneData load(const std::string &file);
+
+    /*!
+     * Parse a text .scene file and group its instances by mesh and texture
+     * @param file - File path to the .scene file
+     * @return Loaded scene description
+     */
+    static SceneData loadText(const std::string &file);
+
+    /*!
+     * Memory map a compiled .scn file, the tables are used in place
+     * @param file - File path to the .scn file
+     * @return Loaded scene description
+     */
+    static SceneData loadBinary(const std::string &file);
+
+    /*!
+     * Save the scene as a compiled .scn file
+     * @param file - File path of the .scn file to write
+     */
+    void saveBinary(const std::string &file) const;
+
+    /*!
+     * Mark the batches whose meshes are small enough to merge, reads every mesh of a parsed scene
+     * @param directory - Directory the mesh paths are relative to, with a trailing separator or empty
+     */
+    void markBatchable(const std::string &directory);
+
+    /*!
+     * Get path of the compiled file that belongs to a .scene file
+     * @param file - File path to the .scene file
+     * @return Same path with the .scn extension
+     */
+    static std::string binaryPath(const std::string &file);
+
+    /*!
+     * Get a string of the blob
+     * @param offset - Offset of the string, NONE for an empty one
+     * @return The string
+     */
+    std::string string(uint32_t offset) const;
+
+    Table<char> strings;
+    Table<Transform> nodes;
+    Table<Batch> batches;
+    Table<Instance> instances;
+    Table<Transform> characters;
+    Table<Light> lamps;
+    Table<Light> lights;
+    Table<Emitter> emitters;
+    Table<Spawn> spawns;
+    Table<Camera> cameras;
+    Table<Streaming> streaming;
+
+private:
+    /*!
+     * Point all tables at the storage of a parsed scene
+     */
+    void view();
+
+    struct Storage {
+        std::string strings;
+        std::vector<Transform> nodes;
+        std::vector<Batch> batches;
+        std::vector<Instance> instances;
+        std::vector<Transform> characters;
+        std::vector<Light> lamps;
+        std::vector<Light> lights;
+        std::vector<Emitter> emitters;
+        std::vector<Spawn> spawns;
+        std::vector<Camera> cameras;
+        std::vector<Streaming> streaming;
+    };
+
+    std::unique_ptr<Storage> storage;
+    std::unique_ptr<ppgso::MappedFile> mapping;
+};
+
+#endif //PPGSO_SCENEDATA_H
@@ -2,36 +2,178 @@
 // Created by madrent on 29/11/2022.
 //
 
+#include <algorithm>
+#include <sstream>
+#include <stdexcept>
+
 #include "SceneManager.h"
 #include "Scene.h"
+#include "AssetLoader.h"
+#include "ResourceCache.h"
 #include "src/project/scenes/AlleyScene.h"
 #include "src/project/scenes/DiscoScene.h"
 
-std::list<std::unique_ptr<Object>>* SceneManager::getSceneObjects(std::string sceneName) {
+SceneObjects* SceneManager::getSceneObjects(std::string sceneName) {
     auto selectedScene = SceneManager::getScene(sceneName);
     return (*selectedScene)->getObjects();
 }
 
-std::list<std::unique_ptr<LightSource>>* SceneManager::getSceneLights(std::string sceneName) {
+SceneLights* SceneManager::getSceneLights(std::string sceneName) {
     auto selectedScene = SceneManager::getScene(sceneName);
     return (*selectedScene)->getLights();
 }
 
 
 std::unique_ptr<GeneralScene> *SceneManager::getScene(std::string sceneName) {
+    // Scenes that were never shown or were unloaded are built on first use
+    if (!isLoaded(sceneName)) {
+        load(sceneName);
+        if (sceneName != active)
+            inactive.push_front(sceneName);
+    }
     auto temp = &scenes.find(sceneName)->second;
     return temp;
 }
 
-SceneManager::SceneManager() {
-    //Init scenes
-    auto alleyScene = std::make_unique<AlleyScene>();
-    auto discoScene = std::make_unique<DiscoScene>();
+SceneManager::SceneManager(size_t inactiveBudget) : budget{inactiveBudget} {
+    //Register scenes, they are built when first needed
+    factories["alley"] = {"alley.scene", [](SceneData data) { return std::make_unique<AlleyScene>(std::move(data)); }};
+    factories["disco"] = {"disco.scene", [](SceneData data) { return std::make_unique<DiscoScene>(std::move(data)); }};
+    names = {"alley", "disco"};
+}
+
+void SceneManager::activate(const std::string &sceneName) {
+    if (sceneName == active) return;
+
+    if (!active.empty()) {
+        successors[active][sceneName]++;
+        inactive.push_front(active);
+    }
+    inactive.remove(sceneName);
+    active = sceneName;
+
+    if (!isLoaded(sceneName))
+        load(sceneName);
+    trim();
+}
+
+void SceneManager::update() {
+    if (active.empty()) return;
+
+    if (preload.name.empty()) {
+        // Preloading while the active scene is still loading would only delay it
+        if (AssetLoader::instance().pending() > 0) return;
+
+        auto next = likelyNext();
+        if (next.empty() || isLoaded(next)) return;
+
+        // The description is read in the background, dropping the preload skips storing it
+        preload.name = next;
+        preload.data = std::make_shared<std::unique_ptr<SceneData>>();
+        std::weak_ptr<std::unique_ptr<SceneData>> target = preload.data;
+        auto sceneFile = factory(next).sceneFile;
+        AssetLoader::instance().submit([target, sceneFile]() -> std::function<void()> {
+            auto data = std::make_shared<SceneData>(SceneData::load(sceneFile));
+            return [target, data]() {
+                if (auto holder = target.lock())
+                    *holder = std::make_unique<SceneData>(std::move(*data));
+            };
+        });
+        return;
+    }
+
+    if (!preload.scene) {
+        if (!*preload.data) return;
+        if (!preload.fetched) fetch();
+        // Without a budget the scene is only built when it is activated
+        if (budget == 0) return;
+        preload.scene = factory(preload.name).build(std::move(**preload.data));
+    }
+    if (!preload.scene->prepare(PRELOAD_BUDGET)) return;
+
+    scenes[preload.name] = std::move(preload.scene);
+    inactive.push_front(preload.name);
+    preload = {};
+    trim();
+}
+
+void SceneManager::stream(Camera &camera, float dt) {
+    auto scene = scenes.find(active);
+    if (scene != scenes.end())
+        scene->second->stream(camera, dt);
+}
+
+void SceneManager::setBudget(size_t inactiveBudget) {
+    budget = inactiveBudget;
+    // A scene built ahead could not be kept, its description is gone so the preload starts over
+    if (budget == 0 && preload.scene)
+        preload = {};
+    trim();
+}
+
+bool SceneManager::isLoaded(const std::string &sceneName) const {
+    return scenes.find(sceneName) != scenes.end();
+}
+
+void SceneManager::load(const std::string &sceneName) {
+    // Meshes and textures that were not fetched ahead start decoding on the loader threads right away
+    std::unique_ptr<GeneralScene> scene;
+    auto &builder = factory(sceneName);
+    if (preload.name == sceneName && preload.scene)
+        scene = std::move(preload.scene);
+    else if (preload.name == sceneName && preload.data && *preload.data)
+        scene = builder.build(std::move(**preload.data));
+    else
+        scene = builder.build(SceneData::load(builder.sceneFile));
+    scene->prepare();
+    scenes[sceneName] = std::move(scene);
+
+    // The fetched resources are held by the scene now
+    if (preload.name == sceneName)
+        preload = {};
+}
+
+const SceneManager::Factory &SceneManager::factory(const std::string &sceneName) const {
+    auto entry = factories.find(sceneName);
+    if (entry == factories.end()) {
+        std::stringstream message;
+        message << "Unknown scene: " << sceneName;
+        throw std::runtime_error(message.str());
+    }
+    return entry->second;
+}
+
+void SceneManager::fetch() {
+    // Meshes only drawn merged are read by the StaticBatcher, they would be decoded for nothing
+    auto &data = **preload.data;
+    for (auto &batch : data.batches) {
+        if (!(batch.flags & SceneData::BATCHABLE))
+            preload.meshes.push_back(ResourceCache::mesh(data.string(batch.mesh)));
+        preload.textures.push_back(ResourceCache::texture(data.string(batch.texture)));
+    }
+    preload.fetched = true;
+}
+
+void SceneManager::trim() {
+    while (inactive.size() > budget) {
+        scenes.erase(inactive.back());
+        inactive.pop_back();
+    }
+}
 
+std::string SceneManager::likelyNext() const {
+    auto history = successors.find(active);
+    if (history != successors.end()) {
+        auto best = std::max_element(history->second.begin(), history->second.end(),
+                                     [](const std::pair<const std::string, int> &a, const std::pair<const std::string, int> &b) {
+                                         return a.second < b.second;
+                                     });
+        return best->first;
+    }
 
-    //Add scenes to available space
-    scenes.insert({"disco", std::move(discoScene)});
-    scenes.insert({"alley", std::move(alleyScene)});
+    auto current = std::find(names.begin(), names.end(), active);
+    if (current == names.end() || names.size() < 2) return "";
+    return *(++current == names.end() ? names.begin() : current);
 }
 
 glm::vec3 SceneManager::getCameraPosition(std::string sceneName) {
@@ -5,18 +5,129 @@
 #ifndef PPGSO_SCENEMANAGER_H
 #define PPGSO_SCENEMANAGER_H
 
+#include <functional>
+#include <list>
 #include <vector>
 #include "src/project/scenes/GeneralScene.h"
 
+/*!
+ * Owns the scenes of the project and keeps only the ones in use loaded
+ * A scene is built the first time it is needed, while it is shown the description of the scene most likely to be
+ * shown next is read on the AssetLoader threads and its meshes and textures are requested, so they decode in the
+ * background before the switch, its objects are only created when it is activated
+ * By default only the active scene is kept, so memory is bounded by one scene plus the assets of the next one
+ * With a budget for inactive scenes the next scene is also built ahead, its objects are added a little every frame,
+ * and inactive scenes stay loaded up to the budget, beyond it the least recently used one is destroyed
+ * and its meshes and textures are released once no other scene shares them
+ */
 class SceneManager{
 private:
+    struct Factory {
+        std::string sceneFile;
+        std::function<std::unique_ptr<GeneralScene>(SceneData)> build;
+    };
+
+    // Scene prepared ahead, the description arrives from the loader threads before its resources are requested
+    struct Preload {
+        std::string name;
+        std::shared_ptr<std::unique_ptr<SceneData>> data;
+        // Meshes and textures of the scene, held until it is built
+        std::vector<std::shared_ptr<ppgso::Mesh>> meshes;
+        std::vector<std::shared_ptr<ppgso::Texture>> textures;
+        bool fetched = false;
+        // Built only when inactive scenes may be kept
+        std::unique_ptr<GeneralScene> scene;
+    };
+
+    // Builders of all known scenes, in the order they were registered
+    std::map<std::string, Factory> factories;
+    std::vector<std::string> names;
+
+    // Loaded scenes, the inactive ones are listed from the most recently used
     std::map<std::string, std::unique_ptr<GeneralScene>> scenes;
+    std::list<std::string> inactive;
+    std::string active;
+    size_t budget;
+
+    // How often each scene was followed by another one
+    std::map<std::string, std::map<std::string, int>> successors;
+
+    Preload preload;
+
+    // Time spent adding the objects of the preloaded scene each frame, in seconds
+    static constexpr double PRELOAD_BUDGET = 0.002;
+
+    /*!
+     * Build a scene right away, a preload of the scene is finished or dropped
+     */
+    void load(const std::string &sceneName);
+
+    /*!
+     * Get the builder of a scene
+     * @return Builder registered for the name, throws for unknown scenes
+     */
+    const Factory &factory(const std::string &sceneName) const;
+
+    /*!
+     * Request the meshes and textures of the preloaded description from the ResourceCache
+     */
+    void fetch();
+
+    /*!
+     * Destroy inactive scenes over the budget, least recently used first
+     */
+    void trim();
+
+    /*!
+     * Guess the scene shown after the active one
+     * @return The scene that followed the active one most often, the next registered one if there is no history yet
+     */
+    std::string likelyNext() const;
+
 public:
-    SceneManager();
+    /*!
+     * Register the scenes without loading any of them
+     * @param inactiveBudget - Number of scenes kept loaded besides the active one, 0 only fetches the assets of the next one
+     */
+    explicit SceneManager(size_t inactiveBudget = 0);
     void init();
 
-    std::list<std::unique_ptr<Object>>* getSceneObjects(std::string sceneName);
-    std::list<std::unique_ptr<LightSource>>* getSceneLights(std::string sceneName);
+    /*!
+     * Make a scene the active one, it is loaded if needed and scenes over the budget are unloaded
+     * Pointers from getSceneObjects and getSceneLights of unloaded scenes become invalid
+     * @param sceneName - Name of the scene
+     */
+    void activate(const std::string &sceneName);
+
+    /*!
+     * Preload the likely next scene once the assets of the active scene are loaded, call once per frame
+     * Its assets are requested right away, when the budget allows keeping it, only a small part of the scene is
+     * built per call, so the frame rate of the active scene holds
+     */
+    void update();
+
+    /*!
+     * Stream the active scene around the camera, call before simulating the frame
+     * @param camera - Camera of the scene
+     * @param dt - Time since the last call
+     */
+    void stream(Camera &camera, float dt);
+
+    /*!
+     * Change the number of inactive scenes kept loaded
+     * @param inactiveBudget - Number of scenes kept loaded besides the active one, 0 only fetches the assets of the next one
+     */
+    void setBudget(size_t inactiveBudget);
+
+    /*!
+     * Check whether a scene is built
+     * @param sceneName - Name of the scene
+     * @return true if the scene is loaded
+     */
+    bool isLoaded(const std::string &sceneName) const;
+
+    SceneObjects* getSceneObjects(std::string sceneName);
+    SceneLights* getSceneLights(std::string sceneName);
 
     glm::vec3 getCameraPosition(std::string sceneName);
     glm::vec3 getCameraLookAtPosition(std::string sceneName);
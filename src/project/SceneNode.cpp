@@ -0,0 +1,12 @@
+#include "SceneNode.h"
+
+bool SceneNode::update(Scene &scene, float dt) {
+    return true;
+}
+
+void SceneNode::render(Scene &scene) {
+}
+
+bool SceneNode::parallelUpdate() const {
+    return true;
+}
@@ -0,0 +1,34 @@
+#ifndef PPGSO_SCENENODE_H
+#define PPGSO_SCENENODE_H
+
+#include "Object.h"
+
+/*!
+ * Scene graph node without geometry
+ * Used as the pivot of a group of objects attached to it through Object::parent,
+ * moving the node moves the whole group
+ */
+class SceneNode final : public Object {
+public:
+    /*!
+     * Nodes do not animate on their own, their transform is set by the scene or their owner
+     * @param scene - Scene to update
+     * @param dt - Time delta
+     * @return Always true, nodes stay in the scene
+     */
+    bool update(Scene &scene, float dt) override;
+
+    /*!
+     * Nodes have nothing to draw, attached objects render themselves
+     * @param scene - Scene to render in
+     */
+    void render(Scene &scene) override;
+
+    /*!
+     * Nodes do not change on update
+     * @return true
+     */
+    bool parallelUpdate() const override;
+};
+
+#endif //PPGSO_SCENENODE_H
@@ -0,0 +1,52 @@
+#ifndef PPGSO_SCENEUNIFORMS_H
+#define PPGSO_SCENEUNIFORMS_H
+
+#include <glm/glm.hpp>
+
+/*!
+ * CPU side layout of the per-frame uniform blocks declared in the project shaders
+ * Members follow the std140 rules, vec3 values are padded to 16 bytes
+ */
+namespace SceneUniforms {
+    // Binding points of the blocks, connected to every program created through the ResourceCache
+    const unsigned int CAMERA_BINDING = 0;
+    const unsigned int LIGHTS_BINDING = 1;
+
+    // Size of the lights array declared in phong_frag_glsl.glsl
+    const int MAX_LIGHTS = 20;
+
+    // uniform Camera
+    struct CameraBlock {
+        glm::mat4 projectionMatrix;
+        glm::mat4 viewMatrix;
+        glm::vec3 viewPosition;
+        float padding0;
+        glm::vec3 lightDirection;
+        float padding1;
+    };
+
+    // struct Lights
+    struct LightData {
+        float type;
+        float padding0[3];
+        glm::vec3 position;
+        float padding1;
+        glm::vec3 color;
+        float brightness;
+        glm::vec3 direction;
+        float padding2;
+    };
+
+    // uniform SceneLights
+    struct LightsBlock {
+        float count;
+        float padding[3];
+        LightData lights[MAX_LIGHTS];
+    };
+
+    static_assert(sizeof(CameraBlock) == 160, "CameraBlock does not match std140 layout");
+    static_assert(sizeof(LightData) == 64, "LightData does not match std140 layout");
+    static_assert(sizeof(LightsBlock) == 16 + MAX_LIGHTS * 64, "LightsBlock does not match std140 layout");
+}
+
+#endif //PPGSO_SCENEUNIFORMS_H
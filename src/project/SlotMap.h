@@ -0,0 +1,192 @@
+#ifndef PPGSO_SLOTMAP_H
+#define PPGSO_SLOTMAP_H
+
+#include <atomic>
+#include <cassert>
+#include <cstdint>
+#include <limits>
+#include <memory>
+#include <string>
+#include <type_traits>
+#include <unordered_map>
+#include <vector>
+
+/*!
+ * Stable reference to an element of a SlotMap
+ * The generation is bumped whenever a slot is freed, so handles to removed elements never resolve to a newer one
+ * The type parameter only tells SlotMap::get what to return, it is not checked
+ */
+template<typename U>
+struct SlotHandle {
+    uint32_t index = std::numeric_limits<uint32_t>::max();
+    uint32_t generation = 0;
+
+    // Handles convert to handles of a base class, the same as pointers
+    template<typename V, typename = typename std::enable_if<std::is_base_of<V, U>::value>::type>
+    operator SlotHandle<V>() const {
+        SlotHandle<V> handle;
+        handle.index = index;
+        handle.generation = generation;
+        return handle;
+    }
+};
+
+/*!
+ * Owning container of polymorphic objects with stable generation-checked handles
+ * Elements are kept packed in a vector so walking them does not chase list nodes,
+ * removal moves the last element into the freed place and updates its slot
+ * Elements can also be registered under a name for lookup from input handlers
+ */
+template<typename T>
+class SlotMap {
+public:
+    using iterator = typename std::vector<std::unique_ptr<T>>::iterator;
+    using const_iterator = typename std::vector<std::unique_ptr<T>>::const_iterator;
+
+    /*!
+     * Add an element
+     * @param value - Element to take ownership of
+     * @param name - Optional name for lookup with find, empty to leave the element unnamed
+     * @return Handle typed to the inserted element
+     */
+    template<typename U>
+    SlotHandle<U> insert(std::unique_ptr<U> value, const std::string &name = "") {
+        uint32_t index;
+        if (freeSlots.empty()) {
+            index = (uint32_t) slots.size();
+            slots.push_back({});
+        } else {
+            index = freeSlots.back();
+            freeSlots.pop_back();
+        }
+
+        revisionCount = nextRevision();
+        slots[index].position = (uint32_t) values.size();
+        values.push_back(std::move(value));
+        valueSlots.push_back(index);
+
+        SlotHandle<U> handle;
+        handle.index = index;
+        handle.generation = slots[index].generation;
+        if (!name.empty())
+            names[name] = {handle.index, handle.generation};
+        return handle;
+    }
+
+    /*!
+     * Remove and destroy an element, handles to it stop resolving
+     * @param handle - Handle of the element
+     * @return false when the handle was already stale
+     */
+    template<typename U>
+    bool erase(SlotHandle<U> handle) {
+        if (!contains(handle)) return false;
+
+        revisionCount = nextRevision();
+        auto &slot = slots[handle.index];
+        auto last = (uint32_t) values.size() - 1;
+        if (slot.position != last) {
+            values[slot.position] = std::move(values[last]);
+            valueSlots[slot.position] = valueSlots[last];
+            slots[valueSlots[last]].position = slot.position;
+        }
+        values.pop_back();
+        valueSlots.pop_back();
+
+        slot.position = FREE;
+        slot.generation++;
+        freeSlots.push_back(handle.index);
+        return true;
+    }
+
+    /*!
+     * Check whether a handle still refers to a live element
+     * @param handle - Handle to check
+     * @return true if get will return the element
+     */
+    template<typename U>
+    bool contains(SlotHandle<U> handle) const {
+        return handle.index < slots.size() &&
+               slots[handle.index].generation == handle.generation &&
+               slots[handle.index].position != FREE;
+    }
+
+    /*!
+     * Resolve a handle
+     * @param handle - Handle returned by insert
+     * @return Element, nullptr if it was removed
+     */
+    template<typename U>
+    U *get(SlotHandle<U> handle) const {
+        if (!contains(handle)) return nullptr;
+        return static_cast<U *>(values[slots[handle.index].position].get());
+    }
+
+    /*!
+     * Get a named element
+     * The caller has to ask for the type the element was inserted with
+     * @param name - Name given to insert
+     * @return Element, nullptr if no live element has that name
+     */
+    template<typename U = T>
+    U *find(const std::string &name) const {
+        auto entry = names.find(name);
+        if (entry == names.end()) return nullptr;
+        auto value = get(entry->second);
+        assert(value == nullptr || dynamic_cast<U *>(value) != nullptr);
+        return static_cast<U *>(value);
+    }
+
+    /*!
+     * Get the handle of the element at a position of the packed storage
+     * @param position - Index into the range iterated by begin and end
+     * @return Handle of the element, valid until the element is removed
+     */
+    SlotHandle<T> handleAt(size_t position) const {
+        SlotHandle<T> handle;
+        handle.index = valueSlots[position];
+        handle.generation = slots[handle.index].generation;
+        return handle;
+    }
+
+    // Iteration over the packed elements, the order changes when elements are removed
+    iterator begin() { return values.begin(); }
+    iterator end() { return values.end(); }
+    const_iterator begin() const { return values.begin(); }
+    const_iterator end() const { return values.end(); }
+
+    size_t size() const { return values.size(); }
+    bool empty() const { return values.empty(); }
+
+    /*!
+     * Get a value that changes on every insert and erase
+     * Values come from a counter shared by all maps of the same type, so a map created where
+     * a destroyed one used to be never repeats the revision of the old map
+     * @return Value that changes whenever the packed order may have changed
+     */
+    size_t revision() const { return revisionCount; }
+
+private:
+    static constexpr uint32_t FREE = std::numeric_limits<uint32_t>::max();
+
+    static size_t nextRevision() {
+        static std::atomic<size_t> counter{0};
+        return ++counter;
+    }
+
+    struct Slot {
+        uint32_t position = FREE;
+        uint32_t generation = 0;
+    };
+
+    // Packed elements and the slot each of them belongs to
+    std::vector<std::unique_ptr<T>> values;
+    std::vector<uint32_t> valueSlots;
+
+    std::vector<Slot> slots;
+    std::vector<uint32_t> freeSlots;
+    std::unordered_map<std::string, SlotHandle<T>> names;
+    size_t revisionCount = nextRevision();
+};
+
+#endif //PPGSO_SLOTMAP_H
@@ -0,0 +1,65 @@
+#include <glm/gtc/matrix_inverse.hpp>
+
+#include "StaticBatcher.h"
+#include "AssetLoader.h"
+
+void StaticBatcher::add(const std::string &meshFile, const std::string &textureFile,
+                        const glm::mat4 &modelMatrix, const glm::vec3 &materialProperties) {
+    auto &group = groups[std::make_tuple(textureFile, materialProperties.x, materialProperties.y, materialProperties.z)];
+    group.texture = textureFile;
+    group.materialProperties = materialProperties;
+    group.pieces.push_back({meshFile, modelMatrix});
+}
+
+std::vector<StaticBatcher::Batch> StaticBatcher::build() {
+    std::vector<Batch> batches;
+    for (auto &entry : groups) {
+        auto &group = entry.second;
+        auto mesh = std::make_shared<ppgso::Mesh>();
+        auto pieces = std::move(group.pieces);
+        AssetLoader::instance().loadMesh(mesh, [pieces]() { return merge(pieces); });
+        batches.push_back({mesh, group.texture, group.materialProperties});
+    }
+    groups.clear();
+    return batches;
+}
+
+ppgso::MeshData StaticBatcher::merge(const std::vector<Piece> &pieces) {
+    std::vector<ppgso::PackedVertex> vertices;
+    std::vector<uint32_t> indices;
+
+    // Pieces mostly share a few meshes, every mesh is read once
+    std::map<std::string, ppgso::MeshData> meshes;
+    for (auto &piece : pieces) {
+        auto entry = meshes.find(piece.meshFile);
+        if (entry == meshes.end())
+            entry = meshes.emplace(piece.meshFile, ppgso::MeshData::load(piece.meshFile)).first;
+
+        auto normalMatrix = glm::inverseTranspose(glm::mat3(piece.modelMatrix));
+        // Mirroring scales turn the faces inside out, swap the winding back
+        auto mirrored = glm::determinant(glm::mat3(piece.modelMatrix)) < 0;
+
+        for (auto &shape : entry->second.shapes) {
+            auto base = (uint32_t) vertices.size();
+            for (uint32_t v = 0; v < shape.vertexCount; v++) {
+                auto vertex = ppgso::unpack(shape.vertices[v]);
+                vertex.position = glm::vec3(piece.modelMatrix * glm::vec4(vertex.position, 1));
+                vertex.normal = normalMatrix * vertex.normal;
+                vertices.push_back(ppgso::pack(vertex));
+            }
+
+            // Merged meshes are not simplified, only the full detail is taken, already in cache order from the
+            // mesh compiler, so the merged mesh is not optimized again
+            auto &level = shape.levels[0];
+            for (uint32_t i = level.firstIndex; i + 2 < level.firstIndex + level.indexCount; i += 3) {
+                indices.push_back(base + shape.index(i));
+                indices.push_back(base + shape.index(mirrored ? i + 2 : i + 1));
+                indices.push_back(base + shape.index(mirrored ? i + 1 : i + 2));
+            }
+        }
+    }
+
+    ppgso::MeshData data;
+    data.addShape(std::move(vertices), indices);
+    return data;
+}
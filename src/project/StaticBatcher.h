@@ -0,0 +1,69 @@
+#ifndef PPGSO_STATICBATCHER_H
+#define PPGSO_STATICBATCHER_H
+
+#include <map>
+#include <memory>
+#include <string>
+#include <tuple>
+#include <vector>
+
+#include <glm/glm.hpp>
+#include <ppgso/ppgso.h>
+
+/*!
+ * Merges the geometry of static models into one mesh in world space per texture and material
+ * Every merged mesh is drawn by a single Model, so walls and floors built from scaled cubes cost one draw call
+ * per texture instead of one object each
+ * Which meshes are small enough to merge is decided by the scene compiler, larger ones keep their own Model with
+ * culling and levels of detail, the geometry is read and merged on the AssetLoader threads
+ */
+class StaticBatcher {
+public:
+    // Merged geometry drawn by one Model
+    struct Batch {
+        // Empty until the AssetLoader uploads the merged geometry
+        std::shared_ptr<ppgso::Mesh> mesh;
+        std::string texture;
+        glm::vec3 materialProperties;
+    };
+
+    /*!
+     * Queue a static model for merging
+     * @param meshFile - Mesh of the model
+     * @param textureFile - Texture of the model
+     * @param modelMatrix - World matrix of the model
+     * @param materialProperties - Shininess, diffuse and specular factors of the model
+     */
+    void add(const std::string &meshFile, const std::string &textureFile,
+             const glm::mat4 &modelMatrix, const glm::vec3 &materialProperties);
+
+    /*!
+     * Start merging the queued models into one mesh per texture and material and clear the queue
+     * @return Merged batches, their vertices are in world space
+     */
+    std::vector<Batch> build();
+
+private:
+    struct Piece {
+        std::string meshFile;
+        glm::mat4 modelMatrix;
+    };
+
+    struct Group {
+        std::string texture;
+        glm::vec3 materialProperties;
+        std::vector<Piece> pieces;
+    };
+
+    /*!
+     * Read, transform and merge the geometry of queued models, runs on a loader thread
+     * @param pieces - Models to merge
+     * @return Geometry of all models in one shape
+     */
+    static ppgso::MeshData merge(const std::vector<Piece> &pieces);
+
+    // Queued models by texture and material
+    std::map<std::tuple<std::string, float, float, float>, Group> groups;
+};
+
+#endif //PPGSO_STATICBATCHER_H
@@ -3,17 +3,14 @@
 //
 
 #include "ThrowedItemGenerator.h"
-#include "src/project/objects/Drip.h"
 #include "Scene.h"
 
-ThrowedItemGenerator::ThrowedItemGenerator(std::vector<glm::vec4> startingPositions) {
+ThrowedItemGenerator::ThrowedItemGenerator(std::vector<glm::vec4> startingPositions, uint64_t seed) : random{seed} {
     this->coordinatesToThrowFrom = startingPositions;
 }
 
 bool ThrowedItemGenerator::update(Scene &scene, float dt) {
-    int spawnPoint = rand()% coordinatesToThrowFrom.size();
-
-    generateModelMatrix();
+    int spawnPoint = random.range(0, (int) coordinatesToThrowFrom.size());
 
     // Accumulate time
     lastSpawnedAgo += dt;
@@ -26,13 +23,11 @@ bool ThrowedItemGenerator::update(Scene &scene, float dt) {
         else
             initialVelocity = {-startingVelocity.x, startingVelocity.y, startingVelocity.z};
 
-        auto obj = std::make_unique<Drip>(true, initialVelocity);
-        obj->position = {coordinatesToThrowFrom[spawnPoint].x,coordinatesToThrowFrom[spawnPoint].y,coordinatesToThrowFrom[spawnPoint].z};
-
-        scene.objects->push_back(move(obj));
+        glm::vec3 initialPosition = {coordinatesToThrowFrom[spawnPoint].x,coordinatesToThrowFrom[spawnPoint].y,coordinatesToThrowFrom[spawnPoint].z};
+        scene.projectiles.spawnBottle(initialPosition, initialVelocity);
 
         lastSpawnedAgo = 0;
-        spawnThreshold = (rand() % (maxst - minst)) + minst;
+        spawnThreshold = random.range(minst, maxst);
     }
 
     return true;
@@ -8,6 +8,7 @@
 
 #include <vector>
 #include "Object.h"
+#include "Random.h"
 
 class ThrowedItemGenerator: public Object {
 protected:
@@ -20,8 +21,10 @@ protected:
     double spawnThreshold = 3;
 
     double lastSpawnedAgo = 0;
+
+    Random random;
 public:
-    explicit ThrowedItemGenerator(std::vector<glm::vec4> startingPositions);
+    explicit ThrowedItemGenerator(std::vector<glm::vec4> startingPositions, uint64_t seed = Random::nextSeed());
     bool update(Scene &scene, float dt) override;
     void render(Scene &scene) override;
 };
@@ -0,0 +1,208 @@
+#include <algorithm>
+#include <cmath>
+
+#include "TransformSystem.h"
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define PPGSO_TRANSFORM_SSE
+#include <xmmintrin.h>
+#endif
+
+namespace {
+    /*!
+     * Model matrix from translation, scale and the sine and cosine of the Euler angles
+     * Rotation part matches glm::orientate4, which is yawPitchRoll(z, x, y)
+     */
+    glm::mat4 composeMatrix(float px, float py, float pz, float scx, float scy, float scz,
+                            float sp, float cp, float sb, float cb, float sh, float ch) {
+        glm::mat4 matrix{1.0f};
+        matrix[0] = glm::vec4(ch * cb + sh * sp * sb, sb * cp, -sh * cb + ch * sp * sb, 0) * scx;
+        matrix[1] = glm::vec4(-ch * sb + sh * sp * cb, cb * cp, sb * sh + ch * sp * cb, 0) * scy;
+        matrix[2] = glm::vec4(sh * cp, -sp, ch * cp, 0) * scz;
+        matrix[3] = glm::vec4(px, py, pz, 1);
+        return matrix;
+    }
+}
+
+glm::mat4 TransformSystem::compose(const glm::vec3 &position, const glm::vec3 &rotation, const glm::vec3 &scale) {
+    return composeMatrix(position.x, position.y, position.z, scale.x, scale.y, scale.z,
+                         std::sin(rotation.x), std::cos(rotation.x),
+                         std::sin(rotation.y), std::cos(rotation.y),
+                         std::sin(rotation.z), std::cos(rotation.z));
+}
+
+size_t TransformSystem::rebuilt() const {
+    return targets.size();
+}
+
+const std::vector<Object *> &TransformSystem::changed() const {
+    return targets;
+}
+
+void TransformSystem::update(SceneObjects &objects) {
+    // Scenes switch the container, so the order is checked against both the container and its revision
+    if (orderedObjects != &objects || orderRevision != objects.revision())
+        sortByDepth(objects);
+
+    pass++;
+    targets.clear();
+    parents.clear();
+    for (auto array : {&positionX, &positionY, &positionZ, &scaleX, &scaleY, &scaleZ,
+                       &sinX, &cosX, &sinY, &cosY, &sinZ, &cosZ})
+        array->clear();
+
+    auto first = objects.begin();
+    for (auto position : order) {
+        auto obj = (first + position)->get();
+        auto parent = objects.get(obj->parent);
+
+        // Parents are visited first, so a parent rebuilt in this pass is already marked
+        bool parentMoved = parent != nullptr && parent->transformPass == pass;
+        if (!parentMoved) {
+            // Static objects keep the matrix they were given on their first update
+            if (obj->staticTransform && obj->transformBuilt) continue;
+            if (!obj->transformChanged()) continue;
+        }
+        obj->transformPass = pass;
+
+        targets.push_back(obj);
+        parents.push_back(parent);
+        positionX.push_back(obj->position.x);
+        positionY.push_back(obj->position.y);
+        positionZ.push_back(obj->position.z);
+        scaleX.push_back(obj->scale.x);
+        scaleY.push_back(obj->scale.y);
+        scaleZ.push_back(obj->scale.z);
+        sinX.push_back(std::sin(obj->rotation.x));
+        cosX.push_back(std::cos(obj->rotation.x));
+        sinY.push_back(std::sin(obj->rotation.y));
+        cosY.push_back(std::cos(obj->rotation.y));
+        sinZ.push_back(std::sin(obj->rotation.z));
+        cosZ.push_back(std::cos(obj->rotation.z));
+    }
+    if (targets.empty()) return;
+
+    compose();
+
+    // Targets are in parent first order, so parent world matrices are final when their children are reached
+    for (size_t i = 0; i < targets.size(); i++) {
+        auto obj = targets[i];
+        auto previous = obj->modelMatrix;
+        if (parents[i] != nullptr)
+            obj->modelMatrix = parents[i]->modelMatrix * matrices[i];
+        else
+            obj->modelMatrix = matrices[i];
+        // A first matrix has nothing to blend from
+        obj->previousModelMatrix = obj->transformBuilt ? previous : obj->modelMatrix;
+        obj->markTransformBuilt();
+    }
+}
+
+void TransformSystem::interpolate(const SceneObjects &objects, float alpha) {
+    simulated.clear();
+    // Targets may point to removed objects once the container changed
+    if (orderedObjects != &objects || orderRevision != objects.revision()) return;
+
+    for (auto obj : targets) {
+        simulated.push_back(obj->modelMatrix);
+        auto &previous = obj->previousModelMatrix;
+        for (int c = 0; c < 4; c++)
+            obj->modelMatrix[c] = glm::mix(previous[c], obj->modelMatrix[c], alpha);
+    }
+}
+
+void TransformSystem::restore() {
+    for (size_t i = 0; i < simulated.size(); i++)
+        targets[i]->modelMatrix = simulated[i];
+    simulated.clear();
+}
+
+void TransformSystem::sortByDepth(SceneObjects &objects) {
+    // Hierarchies in the scenes are shallow, the limit only guards against parent cycles
+    const uint32_t MAX_DEPTH = 64;
+
+    std::vector<uint32_t> depths(objects.size());
+    uint32_t deepest = 0;
+    auto first = objects.begin();
+    for (size_t i = 0; i < objects.size(); i++) {
+        uint32_t depth = 0;
+        auto parent = objects.get((first + i)->get()->parent);
+        while (parent != nullptr && depth < MAX_DEPTH) {
+            depth++;
+            parent = objects.get(parent->parent);
+        }
+        depths[i] = depth;
+        deepest = std::max(deepest, depth);
+    }
+
+    // Counting sort by depth keeps the packed order within each level
+    std::vector<uint32_t> starts(deepest + 2, 0);
+    for (auto depth : depths)
+        starts[depth + 1]++;
+    for (size_t d = 1; d < starts.size(); d++)
+        starts[d] += starts[d - 1];
+    order.resize(objects.size());
+    for (uint32_t i = 0; i < depths.size(); i++)
+        order[starts[depths[i]]++] = i;
+
+    orderedObjects = &objects;
+    orderRevision = objects.revision();
+}
+
+void TransformSystem::compose() {
+    size_t count = targets.size();
+    matrices.resize(count);
+    size_t i = 0;
+
+#ifdef PPGSO_TRANSFORM_SSE
+    // Four objects at a time, each register holds one matrix element of four objects
+    // and is transposed into the matrix columns on store
+    for (; i + 4 <= count; i += 4) {
+        __m128 sp = _mm_loadu_ps(&sinX[i]), cp = _mm_loadu_ps(&cosX[i]);
+        __m128 sb = _mm_loadu_ps(&sinY[i]), cb = _mm_loadu_ps(&cosY[i]);
+        __m128 sh = _mm_loadu_ps(&sinZ[i]), ch = _mm_loadu_ps(&cosZ[i]);
+        __m128 scx = _mm_loadu_ps(&scaleX[i]), scy = _mm_loadu_ps(&scaleY[i]), scz = _mm_loadu_ps(&scaleZ[i]);
+        __m128 shsp = _mm_mul_ps(sh, sp);
+        __m128 chsp = _mm_mul_ps(ch, sp);
+
+        __m128 columns[4][4] = {
+                {
+                        _mm_mul_ps(_mm_add_ps(_mm_mul_ps(ch, cb), _mm_mul_ps(shsp, sb)), scx),
+                        _mm_mul_ps(_mm_mul_ps(sb, cp), scx),
+                        _mm_mul_ps(_mm_sub_ps(_mm_mul_ps(chsp, sb), _mm_mul_ps(sh, cb)), scx),
+                        _mm_setzero_ps()
+                },
+                {
+                        _mm_mul_ps(_mm_sub_ps(_mm_mul_ps(shsp, cb), _mm_mul_ps(ch, sb)), scy),
+                        _mm_mul_ps(_mm_mul_ps(cb, cp), scy),
+                        _mm_mul_ps(_mm_add_ps(_mm_mul_ps(sb, sh), _mm_mul_ps(chsp, cb)), scy),
+                        _mm_setzero_ps()
+                },
+                {
+                        _mm_mul_ps(_mm_mul_ps(sh, cp), scz),
+                        _mm_mul_ps(_mm_sub_ps(_mm_setzero_ps(), sp), scz),
+                        _mm_mul_ps(_mm_mul_ps(ch, cp), scz),
+                        _mm_setzero_ps()
+                },
+                {
+                        _mm_loadu_ps(&positionX[i]),
+                        _mm_loadu_ps(&positionY[i]),
+                        _mm_loadu_ps(&positionZ[i]),
+                        _mm_set1_ps(1.0f)
+                }
+        };
+
+        for (int c = 0; c < 4; c++) {
+            _MM_TRANSPOSE4_PS(columns[c][0], columns[c][1], columns[c][2], columns[c][3]);
+            for (int k = 0; k < 4; k++)
+                _mm_storeu_ps(&matrices[i + k][c][0], columns[c][k]);
+        }
+    }
+#endif
+
+    // Remaining objects, or all of them without SSE
+    for (; i < count; i++) {
+        matrices[i] = composeMatrix(positionX[i], positionY[i], positionZ[i], scaleX[i], scaleY[i], scaleZ[i],
+                                    sinX[i], cosX[i], sinY[i], cosY[i], sinZ[i], cosZ[i]);
+    }
+}
@@ -0,0 +1,96 @@
+#ifndef PPGSO_TRANSFORMSYSTEM_H
+#define PPGSO_TRANSFORMSYSTEM_H
+
+#include <cstddef>
+#include <vector>
+
+#include <glm/glm.hpp>
+
+#include "Object.h"
+
+/*!
+ * Batched model matrix generation for the scene graph
+ * Objects are visited parents first, in an order that is only rebuilt when objects are added or removed
+ * Objects whose position, rotation or scale changed since their matrix was built, or whose parent was rebuilt
+ * in the same pass, are gathered into packed arrays and their local matrices are composed together,
+ * four at a time with SSE when the target supports it
+ * Each rebuilt child then costs a single multiply with the world matrix of its parent
+ * Unchanged subtrees are skipped and static objects are only visited until their first matrix is built
+ * The matrix each rebuilt object had before is kept, so frames rendered between two simulation ticks
+ * can show the objects part of the way between their previous and current transform
+ */
+class TransformSystem {
+public:
+    /*!
+     * Rebuild the world matrices of changed objects and their descendants
+     * @param objects - Objects of the scene
+     */
+    void update(SceneObjects &objects);
+
+    /*!
+     * Compose a single model matrix, same as the batched path
+     * @param position - Translation
+     * @param rotation - Euler angles as used by glm::orientate4
+     * @param scale - Scale along the local axes
+     * @return translate * orientate4 * scale
+     */
+    static glm::mat4 compose(const glm::vec3 &position, const glm::vec3 &rotation, const glm::vec3 &scale);
+
+    /*!
+     * Get number of matrices rebuilt by the last update
+     * @return Number of changed objects
+     */
+    size_t rebuilt() const;
+
+    /*!
+     * Get the objects whose matrix was rebuilt by the last update
+     * @return Objects in parent first order, valid until the next update
+     */
+    const std::vector<Object *> &changed() const;
+
+    /*!
+     * Replace the matrices of the objects rebuilt by the last update with a blend of their previous and current matrix
+     * The matrices are blended component-wise, which stays close to the blended transform for the small change of one tick
+     * Nothing is blended if objects were added or removed since the last update
+     * @param objects - Objects of the scene, the same container that was last updated
+     * @param alpha - Part of a tick elapsed since the last update, 0 shows the previous and 1 the current matrices
+     */
+    void interpolate(const SceneObjects &objects, float alpha);
+
+    /*!
+     * Put back the matrices replaced by interpolate
+     */
+    void restore();
+
+private:
+    /*!
+     * Order the packed objects so every parent comes before its children
+     * @param objects - Objects of the scene
+     */
+    void sortByDepth(SceneObjects &objects);
+
+    /*!
+     * Compose the local matrices of all gathered objects into matrices
+     */
+    void compose();
+
+    // Packed positions of the objects, parents first, valid while the same container is at the same revision
+    std::vector<uint32_t> order;
+    const SceneObjects *orderedObjects = nullptr;
+    size_t orderRevision = 0;
+    uint32_t pass = 0;
+
+    // Gathered inputs, sine and cosine of the angles are taken while gathering
+    std::vector<float> positionX, positionY, positionZ;
+    std::vector<float> scaleX, scaleY, scaleZ;
+    std::vector<float> sinX, cosX, sinY, cosY, sinZ, cosZ;
+
+    std::vector<Object *> targets;
+    std::vector<Object *> parents;
+    std::vector<glm::mat4> matrices;
+
+    // Simulated matrices of the targets while interpolated ones are in place
+    std::vector<glm::mat4> simulated;
+};
+
+#endif //PPGSO_TRANSFORMSYSTEM_H
@@ -0,0 +1,307 @@
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <limits>
+
+#include "WorldStreamer.h"
+#include "Camera.h"
+#include "Model.h"
+#include "Random.h"
+#include "ResourceCache.h"
+#include "SceneNode.h"
+#include "TransformSystem.h"
+#include "ThrowedItemGenerator.h"
+#include "characters/Steve.h"
+#include "objects/Drip.h"
+#include "objects/Floor.h"
+#include "objects/ParticleSystem.h"
+
+namespace {
+    glm::vec3 vector(const float *values) {
+        return {values[0], values[1], values[2]};
+    }
+}
+
+WorldStreamer::WorldStreamer(SceneData data, SceneObjects &objects, SceneLights &lights)
+        : data{std::move(data)}, objects{objects}, lights{lights}, streaming{this->data.streaming.count > 0} {
+    auto &scene = this->data;
+    if (streaming)
+        settings = scene.streaming[0];
+
+    // Cells are created as records land in them, keyed by their coordinates on the ground plane
+    // Cells are referred to by index while partitioning, the vector still grows and moves
+    const size_t RESIDENT_CELL = std::numeric_limits<size_t>::max();
+    std::map<std::pair<int, int>, size_t> cellIndices;
+    std::vector<size_t> nodeCells;
+    auto cellOf = [&](const SceneData::Transform &transform) {
+        // Attached records go where their node went, nodes are declared before the records attached to them
+        if (transform.parent != SceneData::NONE) return nodeCells.at(transform.parent);
+        if (!streaming || (transform.flags & SceneData::RESIDENT)) return RESIDENT_CELL;
+
+        std::pair<int, int> key{(int) std::floor(transform.position[0] / settings.cellSize),
+                                (int) std::floor(transform.position[2] / settings.cellSize)};
+        auto entry = cellIndices.find(key);
+        if (entry == cellIndices.end()) {
+            Cell cell;
+            cell.min = glm::vec2(key.first, key.second) * settings.cellSize;
+            cell.max = cell.min + settings.cellSize;
+            entry = cellIndices.emplace(key, cells.size()).first;
+            cells.push_back(std::move(cell));
+        }
+        return entry->second;
+    };
+    auto cellAt = [&](size_t index) -> Cell & {
+        return index == RESIDENT_CELL ? resident : cells[index];
+    };
+
+    for (uint32_t i = 0; i < scene.nodes.count; i++) {
+        nodeCells.push_back(cellOf(scene.nodes[i]));
+        cellAt(nodeCells.back()).nodes.push_back(i);
+    }
+
+    // Static unnamed instances of batchable meshes are merged instead of getting their own objects
+    instanceBatches.resize(scene.instances.count);
+    mergedInstances.resize(scene.instances.count);
+    for (uint32_t b = 0; b < scene.batches.count; b++) {
+        auto &batch = scene.batches[b];
+        for (uint32_t i = batch.first; i < batch.first + batch.count; i++) {
+            auto &transform = scene.instances[i].transform;
+            glm::mat4 matrix;
+            instanceBatches[i] = b;
+            mergedInstances[i] = (batch.flags & SceneData::BATCHABLE) && transform.name == SceneData::NONE &&
+                                 staticMatrix(transform, matrix);
+            cellAt(cellOf(transform)).instances.push_back(i);
+        }
+    }
+    for (uint32_t i = 0; i < scene.lamps.count; i++)
+        cellAt(cellOf(scene.lamps[i].transform)).lamps.push_back(i);
+    for (uint32_t i = 0; i < scene.emitters.count; i++)
+        cellAt(cellOf(scene.emitters[i].transform)).emitters.push_back(i);
+    nodeHandles.resize(scene.nodes.count);
+
+    acquire(resident);
+}
+
+bool WorldStreamer::prepare(double budget) {
+    auto start = std::chrono::steady_clock::now();
+    auto residentSteps = buildSteps(resident);
+    auto steps = residentSteps + data.characters.count + data.lights.count;
+
+    while (prepared < steps) {
+        auto step = prepared++;
+        if (step < residentSteps) {
+            buildStep(resident, step);
+        } else if (step < residentSteps + data.characters.count) {
+            // Characters are made of several objects, they are always resident
+            auto &transform = data.characters[step - residentSteps];
+            auto steve = std::make_unique<Steve>();
+            steve->position = vector(transform.position);
+            steve->rotation = vector(transform.rotation);
+            steve->scale = vector(transform.scale);
+            if (transform.parent != SceneData::NONE)
+                steve->parent = nodeHandles[transform.parent];
+            Steve::addTo(objects, std::move(steve));
+        } else {
+            // Lights are uploaded in world space and in the order they were declared
+            auto &light = data.lights[step - residentSteps - data.characters.count];
+            auto position = vector(light.transform.position);
+            std::unique_ptr<LightSource> source;
+            if (light.spot)
+                source = std::make_unique<LightSource>(position, vector(light.direction), light.size, vector(light.color), light.brightness);
+            else
+                source = std::make_unique<LightSource>(position, light.size, vector(light.color), light.brightness);
+            lights.insert(std::move(source), data.string(light.transform.name));
+        }
+
+        std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+        if (budget >= 0 && elapsed.count() > budget) break;
+    }
+    return prepared == steps;
+}
+
+void WorldStreamer::update(Camera &camera, float dt) {
+    if (!streaming) return;
+
+    // Jumps further than a cell are cuts to another camera position, not motion
+    auto position = camera.position;
+    if (tracking && dt > 0) {
+        auto moved = position - lastPosition;
+        velocity = glm::length(moved) < settings.cellSize ? moved / dt : glm::vec3{0, 0, 0};
+    }
+    lastPosition = position;
+    tracking = true;
+
+    upcoming = camera.upcomingPath(PATH_SAMPLES);
+    upcoming.push_back(position + velocity * settings.lookahead);
+
+    for (auto &cell : cells) {
+        auto current = distance(cell, position);
+
+        // Resident cells are kept a little longer so cells on the border do not flip every frame
+        State target = UNLOADED;
+        if (current <= settings.radius + (cell.state == RESIDENT ? settings.margin : 0)) {
+            target = RESIDENT;
+        } else if (current <= settings.radius + 2 * settings.margin) {
+            target = PRELOADED;
+        } else {
+            for (auto &point : upcoming) {
+                if (distance(cell, point) <= settings.radius) {
+                    target = PRELOADED;
+                    break;
+                }
+            }
+        }
+
+        if (target == cell.state) continue;
+        if (cell.state == UNLOADED) acquire(cell);
+        if (cell.state == RESIDENT) unload(cell);
+        if (target == UNLOADED) cell.resources.clear();
+        cell.state = target;
+    }
+
+    // Resident cells are built a record at a time, the rest is left for the next update once the budget is spent
+    auto start = std::chrono::steady_clock::now();
+    for (auto &cell : cells) {
+        if (cell.state != RESIDENT) continue;
+        auto steps = buildSteps(cell);
+        while (cell.built < steps) {
+            buildStep(cell, cell.built++);
+            std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+            if (elapsed.count() > BUILD_BUDGET) return;
+        }
+    }
+}
+
+size_t WorldStreamer::residentCells() const {
+    return (size_t) std::count_if(cells.begin(), cells.end(), [](const Cell &cell) { return cell.state == RESIDENT; });
+}
+
+void WorldStreamer::acquire(Cell &cell) {
+    // Requests start decoding on the loader threads, resources already loaded are shared
+    // Merged instances only need the texture, their geometry is in the merged meshes
+    for (auto i : cell.instances) {
+        auto &batch = data.batches[instanceBatches[i]];
+        auto &resources = cell.resources[instanceBatches[i]];
+        if (!resources.first && !mergedInstances[i])
+            resources.first = ResourceCache::mesh(data.string(batch.mesh));
+        if (!resources.second)
+            resources.second = ResourceCache::texture(data.string(batch.texture));
+    }
+
+    if (cell.batched) return;
+    for (auto i : cell.instances) {
+        if (!mergedInstances[i]) continue;
+        auto &instance = data.instances[i];
+        auto &batch = data.batches[instanceBatches[i]];
+        glm::mat4 matrix;
+        staticMatrix(instance.transform, matrix);
+        batcher.add(data.string(batch.mesh), data.string(batch.texture), matrix, vector(instance.material));
+    }
+    cell.merged = batcher.build();
+    cell.batched = true;
+}
+
+size_t WorldStreamer::buildSteps(const Cell &cell) const {
+    return cell.nodes.size() + cell.instances.size() + cell.merged.size() + cell.lamps.size() + cell.emitters.size();
+}
+
+void WorldStreamer::buildStep(Cell &cell, size_t step) {
+    if (step < cell.nodes.size()) {
+        auto i = cell.nodes[step];
+        nodeHandles[i] = add(std::make_unique<SceneNode>(), data.nodes[i]);
+        cell.handles.push_back(nodeHandles[i]);
+        return;
+    }
+    step -= cell.nodes.size();
+
+    // Instances of a cell are grouped by batch, every batch takes its mesh and texture from the cell once
+    if (step < cell.instances.size()) {
+        auto i = cell.instances[step];
+        if (mergedInstances[i]) return;
+        auto &instance = data.instances[i];
+        auto &resources = cell.resources[instanceBatches[i]];
+
+        std::unique_ptr<Model> model;
+        if (instance.transform.flags & SceneData::FLOOR)
+            model = std::make_unique<Floor>(resources.first, resources.second);
+        else
+            model = std::make_unique<Model>(resources.first, resources.second);
+        model->materialProperties = vector(instance.material);
+        cell.handles.push_back(add(std::move(model), instance.transform));
+        return;
+    }
+    step -= cell.instances.size();
+
+    // Textures of the merged batches are held by the cell resources, the cache hands out the same ones
+    if (step < cell.merged.size()) {
+        auto &batch = cell.merged[step];
+        auto model = std::make_unique<Model>(batch.mesh, ResourceCache::texture(batch.texture));
+        model->materialProperties = batch.materialProperties;
+        model->staticTransform = true;
+        cell.handles.push_back(objects.insert(std::move(model)));
+        return;
+    }
+    step -= cell.merged.size();
+
+    if (step < cell.lamps.size()) {
+        auto &lamp = data.lamps[cell.lamps[step]];
+        auto object = std::make_unique<LightSource>(vector(lamp.transform.position), lamp.size, vector(lamp.color), lamp.brightness);
+        cell.handles.push_back(add(std::move(object), lamp.transform));
+        return;
+    }
+    step -= cell.lamps.size();
+
+    // Emitters are seeded from their record, so they repeat the same way however often their cell is rebuilt
+    auto index = cell.emitters[step];
+    auto &emitter = data.emitters[index];
+    std::unique_ptr<Object> object;
+    if (emitter.kind == SceneData::DRIP) {
+        object = std::make_unique<Drip>((emitter.transform.flags & SceneData::BOUNCE) != 0, vector(emitter.velocity),
+                                        (emitter.transform.flags & SceneData::STILL) == 0);
+    } else if (emitter.kind == SceneData::ITEMS) {
+        std::vector<glm::vec4> spawnPoints;
+        for (uint32_t s = emitter.firstSpawn; s < emitter.firstSpawn + emitter.spawnCount; s++) {
+            auto &point = data.spawns[s].point;
+            spawnPoints.emplace_back(point[0], point[1], point[2], point[3]);
+        }
+        object = std::make_unique<ThrowedItemGenerator>(spawnPoints, Random::seedFor(index));
+    } else {
+        object = std::make_unique<ParticleSystem>((int) emitter.amount, Random::seedFor(index));
+    }
+    cell.handles.push_back(add(std::move(object), emitter.transform));
+}
+
+void WorldStreamer::unload(Cell &cell) {
+    for (auto &handle : cell.handles)
+        objects.erase(handle);
+    cell.handles.clear();
+    cell.built = 0;
+}
+
+SlotHandle<Object> WorldStreamer::add(std::unique_ptr<Object> object, const SceneData::Transform &transform) {
+    object->position = vector(transform.position);
+    object->rotation = vector(transform.rotation);
+    object->scale = vector(transform.scale);
+    object->staticTransform = (transform.flags & SceneData::STATIC) != 0;
+    if (transform.parent != SceneData::NONE)
+        object->parent = nodeHandles[transform.parent];
+    return objects.insert(std::move(object), data.string(transform.name));
+}
+
+bool WorldStreamer::staticMatrix(const SceneData::Transform &transform, glm::mat4 &matrix) const {
+    if (!(transform.flags & SceneData::STATIC)) return false;
+
+    matrix = TransformSystem::compose(vector(transform.position), vector(transform.rotation), vector(transform.scale));
+    if (transform.parent == SceneData::NONE) return true;
+
+    glm::mat4 parentMatrix;
+    if (!staticMatrix(data.nodes[transform.parent], parentMatrix)) return false;
+    matrix = parentMatrix * matrix;
+    return true;
+}
+
+float WorldStreamer::distance(const Cell &cell, const glm::vec3 &point) {
+    glm::vec2 ground{point.x, point.z};
+    auto outside = glm::max(glm::max(cell.min - ground, ground - cell.max), glm::vec2{0, 0});
+    return glm::length(outside);
+}
@@ -0,0 +1,163 @@
+#ifndef PPGSO_WORLDSTREAMER_H
+#define PPGSO_WORLDSTREAMER_H
+
+#include <map>
+#include <memory>
+#include <utility>
+#include <vector>
+
+#include <glm/glm.hpp>
+#include <ppgso/ppgso.h>
+
+#include "Object.h"
+#include "LightSource.h"
+#include "SceneData.h"
+#include "StaticBatcher.h"
+
+class Camera;
+
+/*!
+ * Builds the objects of a scene description and keeps only the part around the camera in the scene
+ * The records are partitioned into square cells on the ground plane, cells within the streaming radius of the
+ * camera are resident, their objects are in the scene and simulated, the others are unloaded
+ * Cells the camera is about to reach, judged by its velocity and its scripted transition, are preloaded,
+ * their meshes and textures are requested so the AssetLoader decodes them in the background before they are needed
+ * Lights, characters, records marked resident and everything of scenes without streaming settings are always resident,
+ * records attached to a node are streamed together with it
+ * Static models of batchable batches are merged by a StaticBatcher the first time their cell is acquired
+ * Objects of cells that become resident are added a few at a time within a budget per update, so crossing into
+ * a crowded cell does not stall the frame
+ */
+class WorldStreamer {
+public:
+    /*!
+     * Partition a scene and request the resources of its always resident objects, nothing is added to the scene yet
+     * @param data - Scene description, kept to rebuild cells when they come back
+     * @param objects - Objects of the scene the cells are added to
+     * @param lights - Lights of the scene
+     */
+    WorldStreamer(SceneData data, SceneObjects &objects, SceneLights &lights);
+
+    WorldStreamer(const WorldStreamer&) = delete;
+    WorldStreamer &operator=(const WorldStreamer&) = delete;
+
+    /*!
+     * Build the always resident objects and the lights, continues where the last call stopped
+     * Has to be finished before the scene is shown
+     * @param budget - Time in seconds after which the rest is left for the next call, negative to finish
+     * @return true once everything is built
+     */
+    bool prepare(double budget = -1);
+
+    /*!
+     * Load and unload cells around the camera, call between scene updates
+     * @param camera - Camera the cells are streamed around
+     * @param dt - Time since the last call, used to estimate the camera velocity
+     */
+    void update(Camera &camera, float dt);
+
+    /*!
+     * Get number of cells that currently have their objects in the scene
+     * @return Number of resident cells, including ones still being built, the always resident records are not counted
+     */
+    size_t residentCells() const;
+
+private:
+    enum State {
+        UNLOADED,
+        PRELOADED,
+        RESIDENT
+    };
+
+    struct Cell {
+        // Area covered on the ground plane
+        glm::vec2 min, max;
+        State state = UNLOADED;
+
+        // Indices of the records in the SceneData tables, instances stay grouped by batch
+        std::vector<uint32_t> nodes, instances, lamps, emitters;
+
+        // Meshes and textures of the batches used by the cell, held while preloaded or resident
+        // The mesh is left out for batches only used by merged instances
+        std::map<uint32_t, std::pair<std::shared_ptr<ppgso::Mesh>, std::shared_ptr<ppgso::Texture>>> resources;
+
+        // Merged geometry of the static instances, built once and kept for the cell
+        std::vector<StaticBatcher::Batch> merged;
+        bool batched = false;
+
+        // Objects added to the scene while resident and number of records built so far
+        std::vector<SlotHandle<Object>> handles;
+        size_t built = 0;
+    };
+
+    /*!
+     * Request the meshes and textures of a cell from the ResourceCache
+     */
+    void acquire(Cell &cell);
+
+    /*!
+     * Get number of records building a cell goes through
+     */
+    size_t buildSteps(const Cell &cell) const;
+
+    /*!
+     * Add one record of a cell to the scene
+     * @param step - Index of the record, nodes come first, then instances, merged batches, lamps and emitters
+     */
+    void buildStep(Cell &cell, size_t step);
+
+    /*!
+     * Remove the objects of a cell from the scene, the resources are kept until the cell is released
+     */
+    void unload(Cell &cell);
+
+    /*!
+     * Add an object built from a record to the scene
+     * @return Handle of the added object
+     */
+    SlotHandle<Object> add(std::unique_ptr<Object> object, const SceneData::Transform &transform);
+
+    /*!
+     * Get the world matrix of a record that never moves
+     * @param transform - Transform of the record
+     * @param matrix - Set to the world matrix
+     * @return false when the record or one of the nodes it is attached to is not static
+     */
+    bool staticMatrix(const SceneData::Transform &transform, glm::mat4 &matrix) const;
+
+    /*!
+     * Get distance from a point to the area of a cell on the ground plane
+     */
+    static float distance(const Cell &cell, const glm::vec3 &point);
+
+    SceneData data;
+    SceneObjects &objects;
+    SceneLights &lights;
+    bool streaming;
+    SceneData::Streaming settings = {};
+
+    // Records that are never streamed out, always built
+    Cell resident;
+    std::vector<Cell> cells;
+    // Records built by prepare so far, the resident cell first, then characters and lights
+    size_t prepared = 0;
+
+    // Batch of every instance, whether it is merged and handle of every node while its cell is resident
+    std::vector<uint32_t> instanceBatches;
+    std::vector<bool> mergedInstances;
+    std::vector<SlotHandle<Object>> nodeHandles;
+    StaticBatcher batcher;
+
+    // Camera motion since the last update
+    glm::vec3 lastPosition;
+    glm::vec3 velocity{0, 0, 0};
+    bool tracking = false;
+    std::vector<glm::vec3> upcoming;
+
+    // Points sampled along the rest of a scripted camera transition
+    static constexpr int PATH_SAMPLES = 16;
+    // Time spent adding the objects of resident cells each update, in seconds
+    static constexpr double BUILD_BUDGET = 0.002;
+};
+
+#endif //PPGSO_WORLDSTREAMER_H
@@ -5,8 +5,9 @@
 #include "Steve.h"
 #include "src/project/objects/Cube.h"
 #include "src/project/Model.h"
+#include "src/project/Scene.h"
 
-Steve::Steve() {
+SlotHandle<Steve> Steve::addTo(SceneObjects &objects, std::unique_ptr<Steve> steve) {
     auto body = std::make_unique<Model>("cube.obj", "stars.bmp");
     auto left_leg = std::make_unique<Model>("cube.obj", "grass.bmp");
     auto right_leg = std::make_unique<Model>("cube.obj","grass.bmp");
@@ -51,9 +52,8 @@ Steve::Steve() {
     right_arm->position.y = 0.2;
     right_arm->position.z += 1.1;
 
-    normalArmScaleY = right_arm->scale.y;
-    normalArmPositionY = right_arm->position.y;
-    timePassed = 0;
+    steve->normalArmScaleY = right_arm->scale.y;
+    steve->normalArmPositionY = right_arm->position.y;
 
     head->scale.x /= 2;
     head->scale.z /= 2;
@@ -62,12 +62,19 @@ Steve::Steve() {
     head->rotation.z = - (ppgso::PI / 2);
 
 
-    bodyParts.push_back(move(body));
-    bodyParts.push_back(move(left_leg));
-    bodyParts.push_back(move(right_leg));
-    bodyParts.push_back(move(left_arm));
-    bodyParts.push_back(move(right_arm));
-    bodyParts.push_back(move(head));
+    // Parts are regular scene objects placed relative to Steve
+    auto self = steve.get();
+    auto handle = objects.insert(move(steve));
+    for (Object *part : {body.get(), left_leg.get(), right_leg.get(), left_arm.get(), right_arm.get(), head.get()})
+        part->parent = handle;
+
+    objects.insert(move(body));
+    objects.insert(move(left_leg));
+    objects.insert(move(right_leg));
+    self->leftArm = objects.insert(move(left_arm));
+    self->rightArm = objects.insert(move(right_arm));
+    objects.insert(move(head));
+    return handle;
 }
 
 Steve::Steve(bool isStatic):Steve() {
@@ -75,10 +82,10 @@ Steve::Steve(bool isStatic):Steve() {
 }
 
 void Steve::render(Scene &scene) {
-    for ( auto& obj : bodyParts )
-        obj->render(scene);
+    // Body parts are scene objects and render themselves
 }
 
+
 bool Steve::update(Scene &scene, float dt) {
     //rotation.z += dt/2;
     if(!isStatic){
@@ -92,20 +99,14 @@ bool Steve::update(Scene &scene, float dt) {
             velocity = {3,3,0};
     }
     timePassed += dt*10;
-    int x = 0;
-    for ( auto& obj : bodyParts ){
-        obj->update(scene, dt);
-        obj->modelMatrix = modelMatrix * obj->modelMatrix;
-        if(x == 3 || x == 4){
-            std::cout << dt << std::endl;
-            obj->scale.y =  normalArmScaleY * (sin(timePassed) + 2) / 2;
-            obj->position.y =  normalArmPositionY * (sin(timePassed) + 2);
-            // std::cout << obj->scale.y << std::endl;
-        }
-        x++;
-    }
 
-    generateModelMatrix();
+    // The scene propagates the new matrices to the parts after the update
+    for (auto &handle : {leftArm, rightArm}) {
+        auto arm = scene.objects->get(handle);
+        if (arm == nullptr) continue;
+        arm->scale.y =  normalArmScaleY * (sin(timePassed) + 2) / 2;
+        arm->position.y =  normalArmPositionY * (sin(timePassed) + 2);
+    }
 
     return true;
 }
@@ -7,20 +7,33 @@
 
 
 #include "src/project/Object.h"
+#include "src/project/Model.h"
 
 class Steve final: public Object {
 private:
     glm::vec3 velocity = {3,3,0};
-    std::list<std::unique_ptr<Object>> bodyParts;
     bool isStatic = false;
+
+    // Arms swing with the music, the other body parts just follow Steve
+    SlotHandle<Model> leftArm;
+    SlotHandle<Model> rightArm;
 public:
-    Steve();
+    Steve() = default;
     Steve(bool isStatic);
+
+    /*!
+     * Add Steve to the scene together with its body parts, which are attached to it
+     * @param objects - Objects of the scene
+     * @param steve - Steve placed by its position, rotation and scale
+     * @return Handle to Steve
+     */
+    static SlotHandle<Steve> addTo(SceneObjects &objects, std::unique_ptr<Steve> steve);
+
     void render(Scene &scene);
     bool update(Scene &scene, float time);
     float normalArmScaleY;
     float normalArmPositionY;
-    float timePassed;
+    float timePassed = 0;
 };
 
 
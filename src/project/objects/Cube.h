@@ -2,6 +2,7 @@
 #include "ppgso.h"
 
 #include "src/project/Object.h"
+#include "src/project/PhongUniforms.h"
 
 /*!
  * Simple object representing the player
@@ -10,10 +11,11 @@
  */
 class Cube final : public Object {
 private:
-    // Static resources (Shared between instances)
-    static std::unique_ptr<ppgso::Mesh> mesh;
-    static std::unique_ptr<ppgso::Shader> shader;
-    static std::unique_ptr<ppgso::Texture> texture;
+    // Shared resources (Shared between instances through the ResourceCache)
+    std::shared_ptr<ppgso::Mesh> mesh;
+    std::shared_ptr<ppgso::Shader> shader;
+    std::shared_ptr<ppgso::Texture> texture;
+    PhongUniforms uniforms;
 
     glm::vec3 color = {0, 0, 1};
 
@@ -38,6 +40,26 @@ public:
      */
     void render(Scene &scene) override;
 
+    /*!
+     * Draw the queued cube
+     * @param scene Scene to render in
+     */
+    void draw(Scene &scene) override;
+
+    /*!
+     * Get the bounding sphere of the mesh
+     * @param center - Set to the center of the sphere
+     * @param radius - Set to the radius of the sphere
+     * @return false while the mesh is still loading
+     */
+    bool getBounds(glm::vec3 &center, float &radius) const override;
+
+    /*!
+     * Cubes do not change on update
+     * @return true
+     */
+    bool parallelUpdate() const override;
+
 
     /*!
      * Player click event
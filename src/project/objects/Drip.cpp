@@ -5,21 +5,24 @@
 #include "Drip.h"
 #include "src/project/Scene.h"
 #include "Floor.h"
+#include "src/project/ResourceCache.h"
 #include <shaders/phong_vert_glsl_glsl.h>
 #include <shaders/phong_frag_glsl_glsl.h>
 #include <shaders/color_frag_glsl.h>
-#include <shaders/color_vert_glsl.h>
+#include <shaders/scene_color_vert_glsl.h>
 
 Drip::Drip(bool shouldBounce) {
     this->shouldBounce = shouldBounce;
 
-    //if (!shader) shader = std::make_unique<ppgso::Shader>(phong_vert_glsl_glsl, phong_frag_glsl_glsl);
-    if (!shader) shader = std::make_unique<ppgso::Shader>(color_vert_glsl, color_frag_glsl);
-    if (!mesh) mesh = std::make_unique<ppgso::Mesh>("sphere.obj");
-    if (this->shouldBounce) mesh = std::make_unique<ppgso::Mesh>("bottle.obj");
-    //if (!mesh) mesh = std::make_unique<ppgso::Mesh>("waterDrop.obj");
-    if (!texture) texture = std::make_unique<ppgso::Texture>(ppgso::image::loadBMP("water.bmp"));
-    //if (!texture) texture = std::make_unique<ppgso::Texture>(ppgso::image::loadBMP("waterDrop.bmp"));
+    //shader = ResourceCache::shader(phong_vert_glsl_glsl, phong_frag_glsl_glsl);
+    shader = ResourceCache::shader(scene_color_vert_glsl, color_frag_glsl);
+    mesh = ResourceCache::mesh(this->shouldBounce ? "bottle.obj" : "sphere.obj");
+    //mesh = ResourceCache::mesh("waterDrop.obj");
+    texture = ResourceCache::texture("water.bmp");
+    //texture = ResourceCache::texture("waterDrop.bmp");
+
+    uniforms.modelMatrix = shader->uniform<glm::mat4>("ModelMatrix");
+    uniforms.overallColor = shader->uniform<glm::vec3>("OverallColor");
 
     scale = {2,2,2};
     if (this->shouldBounce)
@@ -34,8 +37,6 @@ bool Drip::update(Scene &scene, float dt) {
         this->velocity.y += dt * gravity;
     }
 
-    generateModelMatrix();
-
     bool hitFloor = false;
     float floorAt = -20;
     /*for ( auto& obj : *scene.objects ) {
@@ -57,37 +58,8 @@ bool Drip::update(Scene &scene, float dt) {
         hitFloor = true;
 
     if(hitFloor && shouldBounce){
-        int newDripParticleCount = rand() % 3 + 2;
-
-        for(int i = 0; i < newDripParticleCount; i++){
-            int randXVelocity = rand() % 10 - 5;
-            int randZVelocity = rand() % 10 - 5;
-            auto newDrop = std::make_unique<Drip>(false);
-            newDrop->position = position;
-            newDrop->position.y = floorAt + 0.5; //spawn it just above the world floor //TODO change it to the collided object y Coordinate
-            newDrop->velocity = { randXVelocity,8,randZVelocity};
-            //newDrop1->scale = {0.02,0.02,0.02};
-            newDrop->scale = {1,1,1};
-
-            scene.objects->push_back(move(newDrop));
-        }
-        /*auto newDrop1 = std::make_unique<Drip>(false);
-        newDrop1->position = position;
-        newDrop1->position.y = floorAt + 0.5; //spawn it just above the world floor //TODO change it to the collided object y Coordinate
-        newDrop1->velocity = { 6,8,6};
-        //newDrop1->scale = {0.02,0.02,0.02};
-        newDrop1->scale = {1,1,1};
-
-        auto newDrop2 = std::make_unique<Drip>(false);
-        newDrop2->position = position;
-        newDrop2->position.y = floorAt + 0.5;
-        newDrop2->velocity = { -6,8,-6};
-        //newDrop2->scale = {0.02,0.02,0.02};
-        newDrop2->scale = {1,1,1};
-
-        scene.objects->push_back(move(newDrop1));
-        scene.objects->push_back(move(newDrop2));
-*/
+        // Splash drops come from the scene's preallocated pool
+        scene.projectiles.shatter(position);
         return false;
     }else if(hitFloor && !shouldBounce)
         return false;
@@ -96,45 +68,22 @@ bool Drip::update(Scene &scene, float dt) {
 }
 
 void Drip::render(Scene &scene) {
-    shader->use();
-
-    // Set up light
-    //shader->setUniform("LightDirection", scene.lightDirection);
-
-    // use camera
-    shader->setUniform("ProjectionMatrix", scene.camera->projectionMatrix);
-    shader->setUniform("ViewMatrix", scene.camera->viewMatrix);
-
-    shader->setUniform("ViewPosition", scene.camera->position);
+    // The color shader does not sample a texture
+    scene.queue.submit(RenderQueue::OPAQUE, *this, *shader, nullptr, mesh.get());
+}
 
+void Drip::draw(Scene &scene) {
     // render mesh
-    shader->setUniform("ModelMatrix", modelMatrix);
-    //shader->setUniform("Texture", *texture);
-
-    shader->setUniform("OverallColor", this->color);
-
-    //shader->setUniform("Lights_count", (float) scene.lights->size());
-
-/*    shader->setUniform("materialShininess", (float) this->materialProperties.x);
-    shader->setUniform("materialDiffuse", (float) this->materialProperties.y);
-    shader->setUniform("materialSpecular", (float) this->materialProperties.z);
-
-    std::list<std::unique_ptr<LightSource>>::iterator it;
-    int i = 0;
-    for (it = scene.lights->begin(); it != scene.lights->end(); ++it){
-        shader->setUniform("lights[" + std::to_string(i) + "].type", (*it)->type);
-        shader->setUniform("lights[" + std::to_string(i) + "].position", (*it)->position);
-        shader->setUniform("lights[" + std::to_string(i) + "].color", (*it)->color);
-        shader->setUniform("lights[" + std::to_string(i) + "].brightness", (*it)->brightness);
-        if((*it)->type == 1) {
-            shader->setUniform("lights[" + std::to_string(i) + "].direction", (*it)->direction);
-        }
-        i++;
-    }*/
+    shader->setUniform(uniforms.modelMatrix, modelMatrix);
+    shader->setUniform(uniforms.overallColor, this->color);
 
     mesh->render();
 }
 
+bool Drip::getBounds(glm::vec3 &center, float &radius) const {
+    return meshBounds(*mesh, center, radius);
+}
+
 Drip::Drip(bool shouldBounce, glm::vec3 initialVelocity): Drip(shouldBounce) {
     this->velocity = initialVelocity;
 }
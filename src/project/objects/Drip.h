@@ -10,9 +10,15 @@
 
 class Drip: public Object {
 private:
-    std::unique_ptr<ppgso::Mesh> mesh;
-    std::unique_ptr<ppgso::Shader> shader;
-    std::unique_ptr<ppgso::Texture> texture;
+    std::shared_ptr<ppgso::Mesh> mesh;
+    std::shared_ptr<ppgso::Shader> shader;
+    std::shared_ptr<ppgso::Texture> texture;
+
+    // Color shader inputs, resolved once in the constructor
+    struct {
+        ppgso::Uniform<glm::mat4> modelMatrix;
+        ppgso::Uniform<glm::vec3> overallColor;
+    } uniforms;
 
     const float gravity = -9.81;
     glm::vec3 velocity = {0,3,0};
@@ -24,6 +30,8 @@ public:
     Drip(bool shouldBounce, glm::vec3 initialVelocity);
     Drip(bool shouldBounce, glm::vec3 initialVelocity, bool shouldMove);
     void render(Scene &scene) override;
+    void draw(Scene &scene) override;
+    bool getBounds(glm::vec3 &center, float &radius) const override;
     bool update(Scene &scene, float dt) override;
 
     void makeItMove();
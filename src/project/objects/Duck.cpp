@@ -48,8 +48,6 @@ bool Duck::update(Scene &scene, float dt) {
     } else {
         rotation.z = 0;
     }*/
-
-    generateModelMatrix();
     return true;
 }
 
@@ -11,6 +11,7 @@
 class Floor: public Model{
 public:
     Floor(const std::string &modelName, const std::string &textureName);
+    Floor(std::shared_ptr<ppgso::Mesh> mesh, std::shared_ptr<ppgso::Texture> texture);
 };
 
 
@@ -9,8 +9,6 @@ Particle::Particle(const std::string &modelName1, const std::string &textureName
 }
 
 bool Particle::update(Scene &scene, float dt) {
-    generateModelMatrix();
-
     ttl -= dt;
 
     return ttl > 0;
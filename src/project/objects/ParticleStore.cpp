@@ -0,0 +1,118 @@
+#include "ParticleStore.h"
+#include "src/project/JobSystem.h"
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define PPGSO_PARTICLE_SSE
+#include <emmintrin.h>
+#endif
+
+void ParticleStore::resize(size_t count) {
+    for (auto array : {&positionX, &positionY, &positionZ,
+                       &velocityX, &velocityY, &velocityZ,
+                       &colorR, &colorG, &colorB, &colorA,
+                       &life, &rotation})
+        array->assign(count, 0.0f);
+    liveCount = 0;
+}
+
+size_t ParticleStore::capacity() const {
+    return life.size();
+}
+
+size_t ParticleStore::alive() const {
+    return liveCount;
+}
+
+size_t ParticleStore::droppedSpawns() const {
+    return dropped;
+}
+
+bool ParticleStore::spawn(glm::vec3 position, glm::vec3 velocity, glm::vec4 color, float life, float rotation) {
+    // Would die before it is ever drawn
+    if (life <= 0.0f) return true;
+
+    if (liveCount == capacity()) {
+        dropped++;
+        return false;
+    }
+
+    auto index = liveCount++;
+    positionX[index] = position.x;
+    positionY[index] = position.y;
+    positionZ[index] = position.z;
+    velocityX[index] = velocity.x;
+    velocityY[index] = velocity.y;
+    velocityZ[index] = velocity.z;
+    colorR[index] = color.r;
+    colorG[index] = color.g;
+    colorB[index] = color.b;
+    colorA[index] = color.a;
+    this->life[index] = life;
+    this->rotation[index] = rotation;
+    return true;
+}
+
+void ParticleStore::kill(size_t index) {
+    liveCount--;
+    if (index != liveCount)
+        move(liveCount, index);
+}
+
+void ParticleStore::move(size_t from, size_t to) {
+    for (auto array : {&positionX, &positionY, &positionZ,
+                       &velocityX, &velocityY, &velocityZ,
+                       &colorR, &colorG, &colorB, &colorA,
+                       &life, &rotation})
+        (*array)[to] = (*array)[from];
+}
+
+void ParticleStore::integrate(float dt, float drag) {
+    // Particles do not depend on each other, only killing has to wait until all chunks are done
+    JobSystem::instance().parallelFor(liveCount, INTEGRATE_GRAIN, [this, dt, drag](size_t begin, size_t end) {
+        advance(begin, end, dt, drag);
+    });
+
+    // Keep live particles packed, the slot of a killed particle is refilled from the end so check it again
+    for (size_t i = 0; i < liveCount;) {
+        if (life[i] <= 0.0f)
+            kill(i);
+        else
+            i++;
+    }
+}
+
+void ParticleStore::advance(size_t begin, size_t end, float dt, float drag) {
+    size_t i = begin;
+
+#ifdef PPGSO_PARTICLE_SSE
+    // Four particles at a time, dead lanes get a zero time step instead of a branch
+    const __m128 dt4 = _mm_set1_ps(dt);
+    const __m128 drag4 = _mm_set1_ps(drag);
+    const __m128 zero = _mm_setzero_ps();
+    for (; i + 4 <= end; i += 4) {
+        __m128 l = _mm_sub_ps(_mm_loadu_ps(&life[i]), dt4);
+        _mm_storeu_ps(&life[i], l);
+
+        __m128 step = _mm_and_ps(_mm_cmpgt_ps(l, zero), dt4);
+
+        __m128 vy = _mm_loadu_ps(&velocityY[i]);
+        _mm_storeu_ps(&positionX[i], _mm_add_ps(_mm_loadu_ps(&positionX[i]), _mm_mul_ps(_mm_loadu_ps(&velocityX[i]), step)));
+        _mm_storeu_ps(&positionY[i], _mm_add_ps(_mm_loadu_ps(&positionY[i]), _mm_mul_ps(vy, step)));
+        _mm_storeu_ps(&positionZ[i], _mm_add_ps(_mm_loadu_ps(&positionZ[i]), _mm_mul_ps(_mm_loadu_ps(&velocityZ[i]), step)));
+        _mm_storeu_ps(&colorA[i], _mm_sub_ps(_mm_loadu_ps(&colorA[i]), step));
+        _mm_storeu_ps(&velocityY[i], _mm_add_ps(vy, _mm_mul_ps(drag4, step)));
+    }
+#endif
+
+    // Remaining particles, or all of them without SSE
+    for (; i < end; i++) {
+        life[i] -= dt;
+        if (life[i] > 0.0f) {
+            positionX[i] += velocityX[i] * dt;
+            positionY[i] += velocityY[i] * dt;
+            positionZ[i] += velocityZ[i] * dt;
+            colorA[i] -= dt;
+            velocityY[i] += drag * dt;
+        }
+    }
+}
@@ -0,0 +1,93 @@
+#ifndef PPGSO_PARTICLESTORE_H
+#define PPGSO_PARTICLESTORE_H
+
+#include <cstddef>
+#include <vector>
+
+#include <glm/glm.hpp>
+
+/*!
+ * Packed structure-of-arrays storage for the particles of a ParticleSystem
+ * Every attribute lives in its own array so the update kernel can process several particles per instruction
+ * Live particles are kept packed at the front of the arrays, [0, alive()), so spawning and killing is O(1)
+ * and update and upload only touch live data
+ */
+class ParticleStore {
+public:
+    std::vector<float> positionX, positionY, positionZ;
+    std::vector<float> velocityX, velocityY, velocityZ;
+    std::vector<float> colorR, colorG, colorB, colorA;
+    std::vector<float> life;
+    // Spin around the vertical axis, applied in particle_vert.glsl
+    std::vector<float> rotation;
+
+    /*!
+     * Change the particle budget, all particles are killed
+     * @param count - Maximum number of live particles
+     */
+    void resize(size_t count);
+
+    /*!
+     * Get the particle budget
+     * @return Maximum number of live particles
+     */
+    size_t capacity() const;
+
+    /*!
+     * Get number of live particles, they occupy indices [0, alive())
+     * @return Number of live particles
+     */
+    size_t alive() const;
+
+    /*!
+     * Get number of spawns rejected because the budget was exhausted
+     * @return Number of dropped spawns since the store was created
+     */
+    size_t droppedSpawns() const;
+
+    /*!
+     * Spawn a particle in the first free slot
+     * @param position - Initial position
+     * @param velocity - Initial velocity
+     * @param color - Initial color, alpha fades out over the particle life
+     * @param life - Time in seconds the particle is alive, particles without life are not stored
+     * @param rotation - Spin of the particle sprite
+     * @return false when the budget is exhausted and the particle was dropped
+     */
+    bool spawn(glm::vec3 position, glm::vec3 velocity, glm::vec4 color, float life, float rotation);
+
+    /*!
+     * Kill a live particle, the last live particle is moved into its slot
+     * @param index - Index of the particle in [0, alive())
+     */
+    void kill(size_t index);
+
+    /*!
+     * Age live particles, move them, fade them out and apply drag along the y axis
+     * Large stores are split into chunks integrated in parallel on the JobSystem,
+     * each chunk uses SSE when the target supports it, particles that run out of life are killed afterwards
+     * @param dt - Time delta
+     * @param drag - Acceleration along the y axis
+     */
+    void integrate(float dt, float drag);
+
+private:
+    // Particles integrated by one job
+    static constexpr size_t INTEGRATE_GRAIN = 4096;
+
+    /*!
+     * Integrate a range of live particles without killing any of them
+     * @param begin - First particle of the range
+     * @param end - End of the range
+     * @param dt - Time delta
+     * @param drag - Acceleration along the y axis
+     */
+    void advance(size_t begin, size_t end, float dt, float drag);
+
+    void move(size_t from, size_t to);
+
+    size_t liveCount = 0;
+    size_t dropped = 0;
+};
+
+#endif //PPGSO_PARTICLESTORE_H
@@ -2,9 +2,11 @@
 // Created by madre on 3/12/2022.
 //
 
+#include <cstddef>
+
 #include "ParticleSystem.h"
-#include "PureParticle.h"
 #include "src/project/Scene.h"
+#include "src/project/ResourceCache.h"
 
 #include <shaders/particle_vert_glsl.h>
 #include <shaders/particle_frag_glsl.h>
@@ -17,26 +19,38 @@ void logVec2(glm::vec2 vector){
 }
 
 void ParticleSystem::render(Scene &scene) {
+    // Drawn after the opaque geometry, the queue binds the sprite shared by all particles
+    scene.queue.submit(RenderQueue::BLENDED, *this, *shader, texture.get(), nullptr);
+}
+
+void ParticleSystem::draw(Scene &scene) {
     glBlendFunc(GL_SRC_ALPHA, GL_ONE);
     glDisable(GL_CULL_FACE);
-    shader->use();
-    for (PureParticle particle : this->particles)
+    // Additive particles do not need sorting, keep them out of the depth buffer so other systems are not hidden
+    glDepthMask(GL_FALSE);
+
+    instances.clear();
+    // Live particles are packed at the front of the store
+    for (size_t i = 0; i < particles.alive(); ++i)
     {
-        if (particle.Life > 0.0f)
-        {
-            shader->setUniform("offset", particle.Position);
-            shader->setUniform("color", particle.Color);
-            shader->setUniform("sprite", *texture);
-            shader->setUniform("projection", scene.camera->projectionMatrix);
-            shader->setUniform("view", scene.camera->viewMatrix);
-            shader->setUniform("model", particle.ModelMatrix);
-
-
-            glBindVertexArray(this->VAO);
-            glDrawArrays(GL_TRIANGLES, 0, 6);
-            glBindVertexArray(0);
-        }
+        instances.push_back({{particles.positionX[i], particles.positionY[i], particles.positionZ[i]},
+                             particles.rotation[i],
+                             {particles.colorR[i], particles.colorG[i], particles.colorB[i], particles.colorA[i]}});
+    }
+
+    if (!instances.empty()) {
+        // Orphan the storage so the upload does not wait for the previous frame's draw
+        glBindBuffer(GL_ARRAY_BUFFER, instanceVBO);
+        glBufferData(GL_ARRAY_BUFFER, this->amount * sizeof(ParticleInstance), nullptr, GL_STREAM_DRAW);
+        glBufferSubData(GL_ARRAY_BUFFER, 0, instances.size() * sizeof(ParticleInstance), instances.data());
+        glBindBuffer(GL_ARRAY_BUFFER, 0);
+
+        // Draw all live particles at once
+        glBindVertexArray(this->VAO);
+        glDrawArraysInstanced(GL_TRIANGLES, 0, 6, (GLsizei) instances.size());
+        glBindVertexArray(0);
     }
+    glDepthMask(GL_TRUE);
     glEnable(GL_CULL_FACE);
     glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
 }
@@ -44,29 +58,20 @@ void ParticleSystem::render(Scene &scene) {
 bool ParticleSystem::update(Scene &scene, float dt) {
     int newParticles = this->amount / 10;
 
-    for (unsigned int i = 0; i < newParticles; ++i){
-        int unusedParticle = this->firstUnusedParticle();
-        this->respawnParticle(this->particles[unusedParticle], glm::vec3{0.5,0.5,0.5});
-//        this->particles[unusedParticle].update(scene, dt);
-    }
+    this->spawnParticles(newParticles, glm::vec3{0.5,0.5,0.5});
 
-    for (unsigned int i = 0; i < this->amount; ++i){
-        PureParticle &temp = this->particles[i];
-        temp.Life -= dt;
-        if (temp.Life > 0.0f){
-            temp.Position += temp.Velocity * dt;
-            temp.Color.a -= dt;
-            temp.Velocity.y += dragPower * dt;
-        }
-        temp.update(scene, dt);
-    }
+    particles.integrate(dt, dragPower);
+
+    return true;
+}
 
+bool ParticleSystem::parallelUpdate() const {
     return true;
 }
 
-ParticleSystem::ParticleSystem() {
-    if (!shader) shader = std::make_unique<ppgso::Shader>(particle_vert_glsl, particle_frag_glsl);
-    if (!texture) texture = std::make_unique<ppgso::Texture>(ppgso::image::loadBMP("explosion.bmp"));
+ParticleSystem::ParticleSystem(int amount, uint64_t seed) : random{seed}, amount{amount} {
+    shader = ResourceCache::shader(particle_vert_glsl, particle_frag_glsl);
+    texture = ResourceCache::texture("explosion.bmp");
 
     float quadSize = 0.3;
     float particle_quad[] = {
@@ -89,70 +94,59 @@ ParticleSystem::ParticleSystem() {
     // set mesh attributes
     glEnableVertexAttribArray(0);
     glVertexAttribPointer(0, 4, GL_FLOAT, GL_FALSE, 4 * sizeof(float), (void*)0);
+
+    // per-instance attributes, advanced once per particle
+    glGenBuffers(1, &this->instanceVBO);
+    glBindBuffer(GL_ARRAY_BUFFER, instanceVBO);
+    glBufferData(GL_ARRAY_BUFFER, this->amount * sizeof(ParticleInstance), nullptr, GL_STREAM_DRAW);
+    glEnableVertexAttribArray(1);
+    glVertexAttribPointer(1, 3, GL_FLOAT, GL_FALSE, sizeof(ParticleInstance), (void*)offsetof(ParticleInstance, position));
+    glVertexAttribDivisor(1, 1);
+    glEnableVertexAttribArray(2);
+    glVertexAttribPointer(2, 1, GL_FLOAT, GL_FALSE, sizeof(ParticleInstance), (void*)offsetof(ParticleInstance, rotation));
+    glVertexAttribDivisor(2, 1);
+    glEnableVertexAttribArray(3);
+    glVertexAttribPointer(3, 4, GL_FLOAT, GL_FALSE, sizeof(ParticleInstance), (void*)offsetof(ParticleInstance, color));
+    glVertexAttribDivisor(3, 1);
     glBindVertexArray(0);
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
 
-    // create this->amount default particle instances
-    for (unsigned int i = 0; i < this->amount; ++i)
-        particles.emplace_back(PureParticle());
+    instances.reserve(this->amount);
 
-    std::cout << "DONE" << particles.size() << std::endl;
+    // create this->amount dead particles, they are spawned over the following frames
+    particles.resize(this->amount);
 }
 
-void ParticleSystem::respawnParticle(PureParticle &particle, glm::vec3 offset) {
-    //Random is used to define the starting position near the Particle systems coordinate system
-    int maxRandom = 2;
-    int minRandom = -1;
-    float randomX = minRandom + static_cast <float> (rand()) /( static_cast <float> (RAND_MAX/(maxRandom-minRandom)));
-    float randomY = minRandom + static_cast <float> (rand()) /( static_cast <float> (RAND_MAX/(maxRandom-minRandom)));
-    float randomZ = minRandom + static_cast <float> (rand()) /( static_cast <float> (RAND_MAX/(maxRandom-minRandom)));
-
-    float randomLife = (rand() % 2);
-
-    int maxVelocity = 2;
-    int minVelocity = -2;
-    float randomVelocityX = minVelocity + static_cast <float> (rand()) /( static_cast <float> (RAND_MAX/(maxVelocity-minVelocity)));
-    float randomVelocityY = 2 + static_cast <float> (rand()) /( static_cast <float> (RAND_MAX/(5-2)));
-    float randomVelocityZ = minVelocity + static_cast <float> (rand()) /( static_cast <float> (RAND_MAX/(maxVelocity-minVelocity)));
-
-    //float rColor = 0.5f + ((rand() % 100) / 100.0f);
-
-    int maxRotation = 6;
-    int minRotation = 0;
-    float randomRotationX = ((rand() % maxRotation) + minRotation);
-    float randomRotationY = ((rand() % maxRotation) + minRotation);
-    float randomRotationZ = ((rand() % maxRotation) + minRotation);
-
-    randomRotationX = 0;
-    randomRotationY = 0;
-    randomRotationZ = minRotation + static_cast <float> (rand()) /( static_cast <float> (RAND_MAX/(maxRotation-minRotation)));
-
-    particle.Color = glm::vec4(1, 1, 1, 1.0f);
-    particle.Life = randomLife;
-    particle.Velocity = {randomVelocityX, randomVelocityY, randomVelocityZ};
-    particle.rotation = {randomRotationX, randomRotationY, randomRotationZ};
-
-    particle.Position.x = this->position.x + randomX + offset.x;
-    particle.Position.y = this->position.y + randomY + offset.y;
-    particle.Position.z = this->position.z + randomZ + offset.z;
-    //logVec3(particle.Color);
+ParticleSystem::~ParticleSystem() {
+    glDeleteBuffers(1, &this->instanceVBO);
+    glDeleteBuffers(1, &this->VBO);
+    glDeleteVertexArrays(1, &this->VAO);
 }
 
-unsigned int lastUsedParticle = 0;
-unsigned int ParticleSystem::firstUnusedParticle(){
-    for (unsigned int i = lastUsedParticle; i < this->amount; ++i){
-        if (this->particles[i].Life <= 0.0f){
-            lastUsedParticle = i;
-            return i;
-        }
-    }
-    for (unsigned int i = 0; i < lastUsedParticle; ++i){
-        if (this->particles[i].Life <= 0.0f){
-            lastUsedParticle = i;
-            return i;
-        }
-    }
+unsigned int ParticleSystem::spawnParticles(unsigned int count, glm::vec3 offset) {
+    // Draw the randomness of the whole batch at once
+    const int valuesPerParticle = 8;
+    randomValues.resize(count * valuesPerParticle);
+    random.fill(randomValues.data(), randomValues.size());
+
+    for (unsigned int i = 0; i < count; ++i) {
+        const float *values = &randomValues[i * valuesPerParticle];
+
+        //Random is used to define the starting position near the Particle systems coordinate system
+        glm::vec3 randomPosition = glm::vec3{-1, -1, -1} + 3.0f * glm::vec3{values[0], values[1], values[2]};
 
-    lastUsedParticle = 0;
+        // Whole seconds, either 0 or 1
+        float randomLife = values[3] < 0.5f ? 0.0f : 1.0f;
 
-    return 0;
-}
\ No newline at end of file
+        glm::vec3 randomVelocity = {-2 + 4 * values[4], 2 + 3 * values[5], -2 + 4 * values[6]};
+
+        // Only the rotation around the vertical axis is used by the shader
+        float randomRotation = 6 * values[7];
+
+        // Budget exhausted, skip the rest of the batch
+        if (!particles.spawn(this->position + randomPosition + offset, randomVelocity,
+                             glm::vec4(1, 1, 1, 1.0f), randomLife, randomRotation))
+            return i;
+    }
+    return count;
+}
@@ -8,27 +8,60 @@
 
 #include "src/project/Object.h"
 #include "Particle.h"
-#include "PureParticle.h"
+#include "ParticleStore.h"
+#include "src/project/Random.h"
 
 class ParticleSystem: public Object {
 protected:
-    std::unique_ptr<ppgso::Texture> texture;
-    std::unique_ptr<ppgso::Shader> shader;
+    std::shared_ptr<ppgso::Texture> texture;
+    std::shared_ptr<ppgso::Shader> shader;
+
+    // Layout of the per-instance data read by particle_vert.glsl
+    struct ParticleInstance {
+        glm::vec3 position;
+        float rotation;
+        glm::vec4 color;
+    };
+
+    // Live particles gathered for the instanced draw, reused between frames
+    std::vector<ParticleInstance> instances;
+
+    // Random source of the spawns and a scratch buffer for the values of one batch
+    Random random;
+    std::vector<float> randomValues;
 
     float dragPower = 5;
 public:
-    ParticleSystem();
-    std::vector<PureParticle> particles;
+    /*!
+     * Create a particle system
+     * @param amount - Number of particles in the pool
+     * @param seed - Seed of the spawn randomness
+     */
+    ParticleSystem(int amount = 10000, uint64_t seed = Random::nextSeed());
+    ~ParticleSystem() override;
+    ParticleStore particles;
 
     bool update(Scene &scene, float dt) override;
     void render(Scene &scene) override;
-    GLuint VAO, VBO;
+    void draw(Scene &scene) override;
+
+    /*!
+     * Particle systems only spawn into and move their own particles
+     * @return true
+     */
+    bool parallelUpdate() const override;
+    GLuint VAO, VBO, instanceVBO;
     int amount = 10000;
 
 
-    void respawnParticle(PureParticle &particle, glm::vec3 offset);
+    /*!
+     * Spawn particles with random velocity near the system position
+     * @param count - Number of particles to spawn
+     * @param offset - Offset of the spawn area from the system position
+     * @return Number of spawned particles, less than count when all particles of the system are alive
+     */
+    unsigned int spawnParticles(unsigned int count, glm::vec3 offset);
     glm::vec3 position = {0,0,0};
-    unsigned int firstUnusedParticle();
 };
 
 
@@ -0,0 +1,108 @@
+#include "ProjectileSystem.h"
+#include "src/project/ResourceCache.h"
+
+#include <shaders/color_frag_glsl.h>
+#include <shaders/scene_color_vert_glsl.h>
+
+namespace {
+    const float GRAVITY = -9.81;
+    // Height of the world floor, TODO change it to the collided object y Coordinate
+    const float FLOOR_AT = -20;
+    const glm::vec3 WATER_COLOR = {0.0001, 0.189, 0.145};
+    const glm::vec3 BOTTLE_SCALE = {0.1, 0.1, 0.1};
+    const glm::vec3 SPLASH_SCALE = {1, 1, 1};
+}
+
+ProjectileSystem::ProjectileSystem(uint64_t seed) : random{seed} {
+    bottles.slots.resize(MAX_BOTTLES);
+    splashes.slots.resize(MAX_SPLASHES);
+
+    shader = ResourceCache::shader(scene_color_vert_glsl, color_frag_glsl);
+    bottleMesh = ResourceCache::mesh("bottle.obj");
+    splashMesh = ResourceCache::mesh("sphere.obj");
+
+    uniforms.modelMatrix = shader->uniform<glm::mat4>("ModelMatrix");
+    uniforms.overallColor = shader->uniform<glm::vec3>("OverallColor");
+}
+
+bool ProjectileSystem::spawnBottle(glm::vec3 position, glm::vec3 velocity) {
+    return spawn(bottles, position, velocity);
+}
+
+bool ProjectileSystem::spawnSplash(glm::vec3 position, glm::vec3 velocity) {
+    return spawn(splashes, position, velocity);
+}
+
+void ProjectileSystem::shatter(glm::vec3 position) {
+    int newDripParticleCount = random.range(2, 5);
+    for (int i = 0; i < newDripParticleCount; i++) {
+        int randXVelocity = random.range(-5, 5);
+        int randZVelocity = random.range(-5, 5);
+        //spawn it just above the world floor
+        spawnSplash({position.x, FLOOR_AT + 0.5f, position.z}, {randXVelocity, 8, randZVelocity});
+    }
+}
+
+bool ProjectileSystem::spawn(Pool &pool, glm::vec3 position, glm::vec3 velocity) {
+    if (pool.count == pool.slots.size()) {
+        dropped++;
+        return false;
+    }
+    pool.slots[pool.count++] = {position, velocity};
+    return true;
+}
+
+void ProjectileSystem::kill(Pool &pool, size_t index) {
+    pool.slots[index] = pool.slots[--pool.count];
+}
+
+void ProjectileSystem::update(float dt) {
+    // Splashes first so the ones spawned by bottles this frame start moving next frame
+    for (size_t i = 0; i < splashes.count;) {
+        auto &splash = splashes.slots[i];
+        splash.position += splash.velocity * dt;
+        splash.velocity.y += GRAVITY * dt;
+        if (splash.position.y < FLOOR_AT)
+            kill(splashes, i);
+        else
+            i++;
+    }
+
+    for (size_t i = 0; i < bottles.count;) {
+        auto &bottle = bottles.slots[i];
+        bottle.position += bottle.velocity * dt;
+        bottle.velocity.y += GRAVITY * dt;
+        if (bottle.position.y < FLOOR_AT) {
+            shatter(bottle.position);
+            kill(bottles, i);
+        } else {
+            i++;
+        }
+    }
+}
+
+void ProjectileSystem::render() {
+    if (bottles.count == 0 && splashes.count == 0) return;
+
+    shader->use();
+    shader->setUniform(uniforms.overallColor, WATER_COLOR);
+    render(bottles, *bottleMesh, BOTTLE_SCALE);
+    render(splashes, *splashMesh, SPLASH_SCALE);
+}
+
+void ProjectileSystem::render(const Pool &pool, ppgso::Mesh &mesh, glm::vec3 scale) {
+    for (size_t i = 0; i < pool.count; i++) {
+        auto modelMatrix = glm::translate(glm::mat4(1.0f), pool.slots[i].position) * glm::scale(glm::mat4(1.0f), scale);
+        shader->setUniform(uniforms.modelMatrix, modelMatrix);
+        mesh.render();
+    }
+}
+
+void ProjectileSystem::clear() {
+    bottles.count = 0;
+    splashes.count = 0;
+}
+
+size_t ProjectileSystem::droppedSpawns() const {
+    return dropped;
+}
@@ -0,0 +1,105 @@
+#ifndef PPGSO_PROJECTILESYSTEM_H
+#define PPGSO_PROJECTILESYSTEM_H
+
+#include <memory>
+#include <vector>
+
+#include <ppgso/ppgso.h>
+#include "src/project/Random.h"
+
+/*!
+ * Fixed capacity pools of thrown bottles and the water splashes they leave behind on impact
+ * Meshes and the shader are loaded once and kept for the lifetime of the system,
+ * spawning only writes a pool slot, it never allocates, touches files or compiles shaders
+ * Needs the OpenGL context to exist when constructed
+ */
+class ProjectileSystem {
+public:
+    static const size_t MAX_BOTTLES = 64;
+    static const size_t MAX_SPLASHES = 256;
+
+    /*!
+     * Create the pools and preload the shared resources
+     * @param seed - Seed of the splash randomness
+     */
+    explicit ProjectileSystem(uint64_t seed = Random::nextSeed());
+
+    /*!
+     * Throw a bottle, it shatters into 2 to 4 splashes when it hits the floor
+     * @param position - Initial position
+     * @param velocity - Initial velocity
+     * @return false when the pool is full and the bottle was dropped
+     */
+    bool spawnBottle(glm::vec3 position, glm::vec3 velocity);
+
+    /*!
+     * Spawn a single water splash drop, it disappears when it hits the floor
+     * @param position - Initial position
+     * @param velocity - Initial velocity
+     * @return false when the pool is full and the splash was dropped
+     */
+    bool spawnSplash(glm::vec3 position, glm::vec3 velocity);
+
+    /*!
+     * Spawn the splashes of a bottle that hit the floor
+     * @param position - Position of the impact
+     */
+    void shatter(glm::vec3 position);
+
+    /*!
+     * Move all projectiles under gravity and resolve floor impacts
+     * @param dt - Time delta
+     */
+    void update(float dt);
+
+    /*!
+     * Render all live projectiles
+     */
+    void render();
+
+    /*!
+     * Remove all live projectiles, used when switching scenes
+     */
+    void clear();
+
+    /*!
+     * Get number of spawns rejected because a pool was full
+     * @return Number of dropped spawns since the system was created
+     */
+    size_t droppedSpawns() const;
+
+private:
+    struct Projectile {
+        glm::vec3 position;
+        glm::vec3 velocity;
+    };
+
+    // Live projectiles are packed at the front of each pool, [0, count)
+    struct Pool {
+        std::vector<Projectile> slots;
+        size_t count = 0;
+    };
+
+    bool spawn(Pool &pool, glm::vec3 position, glm::vec3 velocity);
+    void kill(Pool &pool, size_t index);
+    void render(const Pool &pool, ppgso::Mesh &mesh, glm::vec3 scale);
+
+    Pool bottles;
+    Pool splashes;
+    size_t dropped = 0;
+
+    Random random;
+
+    // Shared resources, pinned so the ResourceCache never releases and reloads them
+    std::shared_ptr<ppgso::Mesh> bottleMesh;
+    std::shared_ptr<ppgso::Mesh> splashMesh;
+    std::shared_ptr<ppgso::Shader> shader;
+
+    // Color shader inputs, resolved once in the constructor
+    struct {
+        ppgso::Uniform<glm::mat4> modelMatrix;
+        ppgso::Uniform<glm::vec3> overallColor;
+    } uniforms;
+};
+
+#endif //PPGSO_PROJECTILESYSTEM_H
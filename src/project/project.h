@@ -18,12 +18,21 @@
 #include "Model.h"
 #include "SceneManager.h"
 #include "src/project/objects/Drip.h"
+#include "AssetLoader.h"
+#include "FixedTimestep.h"
 
 #include <shaders/framebuffer_vert_glsl.h>
 #include <shaders/framebuffer_frag_glsl.h>
 
 const unsigned int SIZE = 1500;
 
+// Time in seconds per frame that may be spent uploading loaded assets to the GPU
+const double UPLOAD_BUDGET = 0.004;
+
+// Simulation ticks per second and the most ticks simulated for one rendered frame
+const float TICK_RATE = 60.0f;
+const int MAX_TICKS_PER_FRAME = 5;
+
 /*!
  * Custom windows for our simple game
  */
@@ -40,6 +49,29 @@ private:
     bool framebufferFilter = false;
     bool lightTimer = false;
     float elapsedTime = 0;
+    // Scene updates run in fixed ticks, frames are rendered as fast as vsync allows or unlocked
+    FixedTimestep timestep{TICK_RATE, MAX_TICKS_PER_FRAME};
+    bool unlockedRender = false;
+
+    /*!
+     * Give each disco reflector a new random color, shared by its model, point light and spot light
+     */
+    void recolorReflectors() {
+        for (std::string name : {"leftReflector", "rightReflector", "middleReflector"}) {
+            auto model = scene.objects->find<LightSource>(name + "Light");
+            auto pointLight = scene.lights->find(name + "Light");
+            auto spotLight = scene.lights->find(name + "Spot");
+            if (model == nullptr || pointLight == nullptr || spotLight == nullptr) {
+                std::cout << "Light pointer NULL" << std::endl;
+                exit(5);
+            }
+
+            glm::vec3 tempColor = spotLight->randomColor();
+            spotLight->setColor(tempColor);
+            pointLight->setColor(tempColor);
+            model->color = tempColor;
+        }
+    }
 
 
     void initScene() {
@@ -110,6 +142,7 @@ private:
         std::string startingScene = "alley"; // Set starting scene here
 
 
+        scm.activate(startingScene);
         scene.lights = (scm.getSceneLights(startingScene));
         scene.objects = (scm.getSceneObjects(startingScene));
         currScene = startingScene;
@@ -139,6 +172,7 @@ public:
         glCullFace(GL_BACK);
 
         glfwSetInputMode(window, GLFW_CURSOR, GLFW_CURSOR_DISABLED);
+        fpsLimit(!unlockedRender);
 
         initScene();
 
@@ -161,6 +195,12 @@ public:
         if (key == GLFW_KEY_P && action == GLFW_PRESS) {
             animate = !animate;
         }
+
+        // Render as fast as possible, the simulation keeps its tick rate either way
+        if (key == GLFW_KEY_V && action == GLFW_PRESS) {
+            unlockedRender = !unlockedRender;
+            fpsLimit(!unlockedRender);
+        }
         if (key == GLFW_KEY_T && action == GLFW_PRESS) {
             if(framebufferFilter) {
                 shader->setUniform("Filter", 0.0f);
@@ -173,51 +213,23 @@ public:
         }
         if (key == GLFW_KEY_1 && action == GLFW_PRESS) {
                 currScene = "alley";
+                scene.projectiles.clear();
+                scm.activate(currScene);
                 scene.lights = scm.getSceneLights(currScene);
                 scene.objects = scm.getSceneObjects(currScene);
                 scene.camera->setToWASD(glm::vec3(5,-10,-5), glm::vec3(5,-10,-6)  );
             }
         if (key == GLFW_KEY_2 && action == GLFW_PRESS) {
                 currScene = "disco";
+                scene.projectiles.clear();
+                scm.activate(currScene);
                 scene.lights = scm.getSceneLights(currScene);
                 scene.objects = scm.getSceneObjects(currScene);
                 scene.camera->setToWASD(glm::vec3(-5,-10,5), glm::vec3(-5,-10,4)  );
         }
         if (key == GLFW_KEY_F && action == GLFW_PRESS) {
             if(currScene == "disco"){
-                LightSource* model = nullptr;
-                LightSource* pointLight = nullptr;
-                LightSource* spotLight = nullptr;
-                glm::vec3 tempColor = {0,0,0};
-                int x = 0;
-                int y = 0;
-                for (auto it = scene.lights->begin(); it != scene.lights->end(); ++it) {
-                    pointLight = dynamic_cast<LightSource*>(it->get());
-                    ++it;
-                    spotLight = dynamic_cast<LightSource*>(it->get());
-
-                    if (spotLight != nullptr || pointLight != nullptr){
-                        tempColor = spotLight->randomColor();
-
-                        spotLight->setColor(tempColor);
-                        pointLight->setColor(tempColor);
-                        y = 0;
-                        for (auto it_o = scene.objects->begin(); it_o != scene.objects->end(); ++it_o) {
-                            if(y == (x / 2) ){
-                                model = dynamic_cast<LightSource*>(it_o->get());
-                                model->color = tempColor;
-                            }
-                            y++;
-                        }
-
-                    }
-                    else{
-                        std::cout << "Light pointer NULL" << std::endl;
-                        exit(5);
-                    }
-                    x += 2;
-                }
-
+                recolorReflectors();
             }
         }
         if (key == GLFW_KEY_C && action == GLFW_PRESS) {
@@ -237,15 +249,7 @@ public:
                 scene.camera->transitionTo(glm::vec3(2.73634, 82.3505, -324.54), glm::vec3(2.73634, 82.3505, -324.54),
                                            glm::vec3(2.73634, 82.3505, -60.1613), glm::vec3(2.73634, 81.3507, -60.1787),
                                            750);
-                int x = 0;
-                Model *model = nullptr;
-                for (auto it = scene.objects->begin(); it != scene.objects->end(); ++it) {
-                    if (x == 1) {
-                        model = dynamic_cast<Model *>(it->get());
-                        break;
-                    }
-                    x++;
-                }
+                Model *model = scene.objects->find<Model>("benceMoving");
                 if (model != nullptr) {
                     //model->transitionTo(model->position,model->rotation, glm::vec3(model->position.x + 75,model->position.y,model->position.z), glm::vec3(model->rotation.x,model->rotation.y,model->rotation.z - ppgso::PI/2), 100);
                     model->transitionToBezier({
@@ -277,15 +281,7 @@ public:
         if (key == GLFW_KEY_4 && action == GLFW_PRESS) {
             if (currScene == "alley") {
                 scene.camera->setToStationary(glm::vec3(10, 0, -80), glm::vec3(-10, -5, -110));
-                int x = 0;
-                Model *model = nullptr;
-                for (auto it = scene.objects->begin(); it != scene.objects->end(); ++it) {
-                    if (x == 3) {
-                        model = dynamic_cast<Model *>(it->get());
-                        break;
-                    }
-                    x++;
-                }
+                Model *model = scene.objects->find<Model>("fire2");
                 if (model != nullptr) {
                     //model->transitionTo(model->position,model->rotation, glm::vec3(model->position.x + 75,model->position.y,model->position.z), glm::vec3(model->rotation.x,model->rotation.y,model->rotation.z - ppgso::PI/2), 100);
                     model->transitionToBezier({
@@ -315,15 +311,7 @@ public:
                 scene.camera->setToStationary(glm::vec3(33.7666, 2, -275.592), glm::vec3(33.1623, 1.80919, -274.819) );
             } else if(currScene == "disco"){
                 scene.camera->setToStationary(glm::vec3(24.3108, -10, 18.1034),glm::vec3(23.7027, -10.1564, 17.3251));
-                int x = 0;
-                Model *model = nullptr;
-                for (auto it = scene.objects->begin(); it != scene.objects->end(); ++it) {
-                    if (x == 3) {
-                        model = dynamic_cast<Model *>(it->get());
-                        break;
-                    }
-                    x++;
-                }
+                Model *model = scene.objects->find<Model>("man1");
                 if (model != nullptr) {
                     model->transitionTo( glm::vec3(-23.4321, model->position.y,-3.19529), model->rotation, glm::vec3(12.7645, model->position.y, 4.53337), model->rotation, 600);
                 }
@@ -341,15 +329,7 @@ public:
                         }, glm::vec3(4.3, -16.0523, -300), glm::vec3(4.3, -16.0523, -310.587), 450
                 );
             } else if(currScene == "disco"){
-                int x = 0;
-                Drip *drip = nullptr;
-                for (auto it = scene.objects->begin(); it != scene.objects->end(); ++it) {
-                    if (x == 23) {
-                        drip = dynamic_cast<Drip *>(it->get());
-                        break;
-                    }
-                    x++;
-                }
+                Drip *drip = scene.objects->find<Drip>("dripBottle");
                 if (drip != nullptr) {
                     drip->makeItMove();
                 }
@@ -360,15 +340,7 @@ public:
             if(currScene == "alley") {
                 scene.camera->setToStationary(glm::vec3(6.79578, 2, -305.328),glm::vec3(6.71745, 2.43837, -306.223));
             } else if(currScene == "disco"){
-                int x = 0;
-                Model *model = nullptr;
-                for (auto it = scene.objects->begin(); it != scene.objects->end(); ++it) {
-                    if (x == 3) {
-                        model = dynamic_cast<Model *>(it->get());
-                        break;
-                    }
-                    x++;
-                }
+                Model *model = scene.objects->find<Model>("man1");
                 if (model != nullptr) {
                     model->transitionToBezier(
                             {
@@ -380,15 +352,7 @@ public:
                             model->rotation, glm::vec3(model->rotation.x,model->rotation.y,model->rotation.z - ppgso::PI/2), 600);
                 }
                 //--------------------
-                x = 0;
-                model = nullptr;
-                for (auto it = scene.objects->begin(); it != scene.objects->end(); ++it) {
-                    if (x == 4) {
-                        model = dynamic_cast<Model *>(it->get());
-                        break;
-                    }
-                    x++;
-                }
+                model = scene.objects->find<Model>("bartender");
                 if (model != nullptr) {
                     model->transitionTo(
                         model->position,
@@ -411,15 +375,7 @@ public:
             if(currScene == "alley") {
                 scene.camera->transitionTo(glm::vec3(-46.0399, -4, -317.23), glm::vec3(-46.8055, -4.0349, -317.872 ),glm::vec3(-73.1067, -4, -323.819), glm::vec3(-74.0272, -4, -324.209 ), 150);
             } else if(currScene == "disco"){
-                int x = 0;
-                Model* model = nullptr;
-                for (auto it = scene.objects->begin(); it != scene.objects->end(); ++it) {
-                    if (x == 4) {
-                        model = dynamic_cast<Model *>(it->get());
-                        break;
-                    }
-                    x++;
-                }
+                Model *model = scene.objects->find<Model>("bartender");
                 if (model != nullptr) {
                     model->transitionTo(
                             model->position,
@@ -457,9 +413,32 @@ public:
             scene.camera->moveDown();
         }
         if (key == GLFW_KEY_G &&  (action == GLFW_PRESS || GLFW_REPEAT)){
-            auto drip = std::make_unique<Drip>(true);
-            drip->position = {5,0,-70};
-            scene.objects->push_back(move(drip));
+            scene.projectiles.spawnBottle({5,0,-70}, {0,3,0});
+        }
+    }
+
+    void onCursorPos(double cursorX, double cursorY) override {
+        scene.cursor.x = cursorX;
+        scene.cursor.y = cursorY;
+    }
+
+    void onMouseButton(int button, int action, int mods) override {
+        if(button == GLFW_MOUSE_BUTTON_LEFT) {
+            scene.cursor.left = action == GLFW_PRESS;
+
+            if (scene.cursor.left) {
+                // The cursor is captured for looking around, so pick through the middle of the screen
+                auto direction = scene.camera->cast(0, 0);
+                auto position = scene.camera->position;
+
+                // Pass on the click event to all objects hit by the ray
+                for (auto &obj : scene.intersect(position, direction)) {
+                    obj->onClick(scene);
+                }
+            }
+        }
+        if(button == GLFW_MOUSE_BUTTON_RIGHT) {
+            scene.cursor.right = action == GLFW_PRESS;
         }
     }
 
@@ -467,6 +446,11 @@ public:
    * Window update implementation that will be called automatically from pollEvents
    */
     void onIdle() override {
+        // Upload assets decoded by the loader threads since the last frame
+        AssetLoader::instance().processUploads(UPLOAD_BUDGET);
+        // Start building the next scene once the current one is loaded
+        scm.update();
+
         // Track time
         static auto time = (float) glfwGetTime();
 
@@ -494,39 +478,7 @@ public:
             if(elapsedTime > .6){
                 elapsedTime = 0;
                 if(currScene == "disco"){
-                    LightSource* model = nullptr;
-                    LightSource* pointLight = nullptr;
-                    LightSource* spotLight = nullptr;
-                    glm::vec3 tempColor = {0,0,0};
-                    int x = 0;
-                    int y = 0;
-                    for (auto it = scene.lights->begin(); it != scene.lights->end(); ++it) {
-                        pointLight = dynamic_cast<LightSource*>(it->get());
-                        ++it;
-                        spotLight = dynamic_cast<LightSource*>(it->get());
-
-                        if (spotLight != nullptr || pointLight != nullptr){
-                            tempColor = spotLight->randomColor();
-
-                            spotLight->setColor(tempColor);
-                            pointLight->setColor(tempColor);
-                            y = 0;
-                            for (auto it_o = scene.objects->begin(); it_o != scene.objects->end(); ++it_o) {
-                                if(y == (x / 2) ){
-                                    model = dynamic_cast<LightSource*>(it_o->get());
-                                    model->color = tempColor;
-                                }
-                                y++;
-                            }
-
-                        }
-                        else{
-                            std::cout << "Light pointer NULL" << std::endl;
-                            exit(5);
-                        }
-                        x += 2;
-                    }
-
+                    recolorReflectors();
                 }
             }
         }
@@ -545,9 +497,13 @@ public:
         glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
 
 
-        // Update and render all objects
-        scene.update(dt);
-        scene.render();
+        // Simulate whole ticks of the elapsed time, then render part of the way towards the next tick
+        // Bring in the parts of the scene around the camera before they are simulated
+        scm.stream(*scene.camera, dt);
+        int ticks = timestep.advance(dt);
+        for (int i = 0; i < ticks; i++)
+            scene.update(timestep.tickTime());
+        scene.render(timestep.alpha());
 
         resetViewport();
         glBindFramebuffer(GL_FRAMEBUFFER, 0);
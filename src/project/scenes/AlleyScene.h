@@ -9,10 +9,12 @@
 #include "GeneralScene.h"
 
 class AlleyScene : public GeneralScene {
-protected:
-    glm::vec3 defaultCameraPos{-5, -10, 5};
 public:
-    AlleyScene();
+    /*!
+     * Set up the scene from its description
+     * @param data - Contents of data/alley.scene
+     */
+    explicit AlleyScene(SceneData data);
 };
 
 
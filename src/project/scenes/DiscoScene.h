@@ -9,10 +9,12 @@
 #include "GeneralScene.h"
 
 class DiscoScene: public GeneralScene {
-protected:
-    glm::vec3 defaultCameraPos{-5, -10, 5}; //TODO make it look where it is supposed to
 public:
-    DiscoScene();
+    /*!
+     * Set up the scene from its description
+     * @param data - Contents of data/disco.scene
+     */
+    explicit DiscoScene(SceneData data);
 };
 
 
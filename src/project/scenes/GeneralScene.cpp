@@ -6,11 +6,31 @@
 #include "src/project/Object.h"
 #include "GeneralScene.h"
 #include "src/project/LightSource.h"
+#include "src/project/SceneData.h"
 
-std::list<std::unique_ptr<Object>>* GeneralScene::getObjects() {
+SceneObjects* GeneralScene::getObjects() {
     return (&objects);
 }
 
-std::list<std::unique_ptr<LightSource>>* GeneralScene::getLights() {
+SceneLights* GeneralScene::getLights() {
     return (&lights);
 }
+
+void GeneralScene::load(SceneData data) {
+    for (auto &camera : data.cameras) {
+        if (data.string(camera.name) != "default") continue;
+        defaultCameraPos = {camera.position[0], camera.position[1], camera.position[2]};
+        defaultCameraLookAtPos = {camera.target[0], camera.target[1], camera.target[2]};
+    }
+
+    streamer = std::make_unique<WorldStreamer>(std::move(data), objects, lights);
+}
+
+bool GeneralScene::prepare(double budget) {
+    return !streamer || streamer->prepare(budget);
+}
+
+void GeneralScene::stream(Camera &camera, float dt) {
+    if (streamer)
+        streamer->update(camera, dt);
+}
@@ -6,18 +6,48 @@
 #define PPGSO_GENERALSCENE_H
 
 #include "src/project/Object.h"
-#include "src/project/LightSource.h."
+#include "src/project/LightSource.h"
+#include "src/project/WorldStreamer.h"
 
 class GeneralScene {
 protected:
-    std::list< std::unique_ptr<Object>> objects;
+    SceneObjects objects;
 
-    std::list< std::unique_ptr<LightSource>> lights;
+    SceneLights lights;
+
+    // Builds the objects of a loaded scene file and streams them around the camera
+    std::unique_ptr<WorldStreamer> streamer;
+
+    /*!
+     * Take the default camera of a scene description and set up the objects and lights it describes
+     * Models are created batch by batch, so each mesh and texture is taken from the ResourceCache once
+     * When the description sets up streaming only the always resident objects are added, the rest follows the camera
+     * The objects are added by prepare
+     * @param data - Scene description, read by the SceneManager
+     */
+    void load(SceneData data);
 public:
+    // Scenes are destroyed through the SceneManager when they are unloaded
+    virtual ~GeneralScene() = default;
+
+    /*!
+     * Add the objects and lights of the loaded scene description, continues where the last call stopped
+     * @param budget - Time in seconds after which the rest is left for the next call, negative to finish
+     * @return true once the scene is ready to be shown
+     */
+    bool prepare(double budget = -1);
+
+    /*!
+     * Load and unload the parts of a streamed scene around the camera, call between scene updates
+     * @param camera - Camera of the scene
+     * @param dt - Time since the last call
+     */
+    void stream(Camera &camera, float dt);
+
     glm::vec3 defaultCameraPos{-5, 5, 0};
     glm::vec3 defaultCameraLookAtPos{0, 0, 0};
-    std::list< std::unique_ptr<Object>>* getObjects();
-    std::list< std::unique_ptr<LightSource>>* getLights();
+    SceneObjects* getObjects();
+    SceneLights* getLights();
 };
 
 #endif //PPGSO_GENERALSCENE_H
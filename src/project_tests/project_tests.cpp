@@ -0,0 +1,553 @@
+// Test project_tests
+// - Checks the pure CPU parts of the project without opening a window
+// - Scene descriptions from data are compiled, saved, loaded back and compared with the source
+// - Levels of detail generated for OBJ meshes from data are checked for valid and shrinking index ranges
+// - Compressed and reordered meshes are saved, loaded back and compared, vertex compression is checked for precision
+// - Containers and systems built on plain data are exercised directly
+// - Random render queue keys are sorted by the radix sort and compared with std::stable_sort
+// - Usage: project_tests data_directory, run by ctest
+
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <numeric>
+#include <random>
+#include <ppgso/ppgso.h>
+
+#include <glm/gtc/matrix_transform.hpp>
+#include <glm/gtx/euler_angles.hpp>
+
+#include "src/project/BoundingVolumeHierarchy.h"
+#include "src/project/FixedTimestep.h"
+#include "src/project/Random.h"
+#include "src/project/RenderQueue.h"
+#include "src/project/SceneData.h"
+#include "src/project/SlotMap.h"
+#include "src/project/TransformSystem.h"
+#include "src/project/objects/ParticleStore.h"
+
+namespace {
+  int failures = 0;
+
+  void check(bool condition, const char *expression, const std::string &context, int line) {
+    if (condition) return;
+    std::cerr << "Check failed at line " << line << ": " << expression << " (" << context << ")" << std::endl;
+    failures++;
+  }
+
+#define CHECK(condition, context) check((condition), #condition, (context), __LINE__)
+
+  template<typename T>
+  bool sameTable(const SceneData::Table<T> &a, const SceneData::Table<T> &b) {
+    return a.count == b.count && (a.count == 0 || std::memcmp(a.records, b.records, a.count * sizeof(T)) == 0);
+  }
+
+  void testScene(const std::string &directory, const std::string &name) {
+    auto parsed = SceneData::loadText(directory + name);
+    parsed.markBatchable(directory);
+    auto file = "test_" + SceneData::binaryPath(name);
+    parsed.saveBinary(file);
+
+    auto compiled = SceneData::loadBinary(file);
+    CHECK(sameTable(parsed.strings, compiled.strings), name);
+    CHECK(sameTable(parsed.nodes, compiled.nodes), name);
+    CHECK(sameTable(parsed.batches, compiled.batches), name);
+    CHECK(sameTable(parsed.instances, compiled.instances), name);
+    CHECK(sameTable(parsed.characters, compiled.characters), name);
+    CHECK(sameTable(parsed.lamps, compiled.lamps), name);
+    CHECK(sameTable(parsed.lights, compiled.lights), name);
+    CHECK(sameTable(parsed.emitters, compiled.emitters), name);
+    CHECK(sameTable(parsed.spawns, compiled.spawns), name);
+    CHECK(sameTable(parsed.cameras, compiled.cameras), name);
+    CHECK(sameTable(parsed.streaming, compiled.streaming), name);
+
+    // Batches cover the instances exactly once, in order
+    uint32_t next = 0;
+    for (auto &batch : compiled.batches) {
+      CHECK(batch.first == next && batch.count > 0, name);
+      next = batch.first + batch.count;
+    }
+    CHECK(next == compiled.instances.count, name);
+  }
+
+  void testLevels(const std::string &directory, const std::string &name, bool reducible) {
+    auto mesh = ppgso::MeshData::loadObj(directory + name);
+    std::vector<uint32_t> fullDetail;
+    for (auto &shape : mesh.shapes)
+      fullDetail.push_back(shape.indexCount);
+
+    mesh.generateLevels(4);
+    CHECK(mesh.levelCount() == 4, name);
+    CHECK(mesh.levelError(0) == 0, name);
+    for (uint32_t l = 1; l < mesh.levelCount(); l++)
+      CHECK(mesh.levelError(l) >= mesh.levelError(l - 1), name);
+
+    uint32_t fullTriangles = 0, coarseTriangles = 0;
+    for (size_t s = 0; s < mesh.shapes.size(); s++) {
+      auto &shape = mesh.shapes[s];
+      CHECK(shape.levelCount == 4, name);
+      if (shape.levelCount != 4) continue;
+      CHECK(shape.levels[0].indexCount == fullDetail[s], name);
+
+      // Every level stays inside the index block, is made of whole triangles and is no larger than the one before
+      for (uint32_t l = 0; l < shape.levelCount; l++) {
+        auto &level = shape.levels[l];
+        CHECK(level.firstIndex + (uint64_t) level.indexCount <= shape.indexCount && level.indexCount % 3 == 0, name);
+        CHECK(l == 0 || level.indexCount <= shape.levels[l - 1].indexCount, name);
+      }
+      uint32_t largest = 0;
+      for (uint32_t i = 0; i < shape.indexCount; i++)
+        largest = std::max(largest, shape.index(i));
+      CHECK(shape.indexCount == 0 || largest < shape.vertexCount, name);
+
+      fullTriangles += shape.levels[0].indexCount / 3;
+      coarseTriangles += shape.levels[3].indexCount / 3;
+    }
+    CHECK(reducible ? coarseTriangles < fullTriangles : coarseTriangles == fullTriangles, name);
+  }
+
+  // Triangles of the full detail as position triples in a canonical order, independent of vertex and triangle order
+  std::vector<std::vector<float>> triangles(const ppgso::MeshData &mesh) {
+    std::vector<std::vector<float>> result;
+    for (auto &shape : mesh.shapes) {
+      auto &level = shape.levels[0];
+      for (uint32_t i = level.firstIndex; i < level.firstIndex + level.indexCount; i += 3) {
+        std::vector<float> triangle;
+        for (uint32_t corner = 0; corner < 3; corner++) {
+          auto &position = shape.vertices[shape.index(i + corner)].position;
+          triangle.insert(triangle.end(), {position.x, position.y, position.z});
+        }
+        result.push_back(triangle);
+      }
+    }
+    std::sort(result.begin(), result.end());
+    return result;
+  }
+
+  void testMesh(const std::string &directory, const std::string &name) {
+    auto source = ppgso::MeshData::loadObj(directory + name);
+    source.generateLevels(4);
+    auto before = triangles(source);
+    source.optimize();
+    CHECK(triangles(source) == before, name);
+
+    auto file = "test_" + ppgso::MeshData::binaryPath(name);
+    source.saveBinary(file);
+
+    auto compiled = ppgso::MeshData::loadBinary(file);
+    CHECK(compiled.shapes.size() == source.shapes.size(), name);
+    CHECK(compiled.min == source.min && compiled.max == source.max, name);
+    CHECK(compiled.center == source.center && compiled.radius == source.radius, name);
+
+    for (size_t s = 0; s < std::min(compiled.shapes.size(), source.shapes.size()); s++) {
+      auto &a = source.shapes[s];
+      auto &b = compiled.shapes[s];
+      CHECK(a.vertexCount == b.vertexCount && a.indexCount == b.indexCount && a.indexSize == b.indexSize, name);
+      CHECK(a.levelCount == b.levelCount, name);
+      if (a.vertexCount != b.vertexCount || a.indexCount != b.indexCount || a.indexSize != b.indexSize ||
+          a.levelCount != b.levelCount)
+        continue;
+
+      CHECK(std::memcmp(a.vertices, b.vertices, a.vertexCount * sizeof(ppgso::PackedVertex)) == 0, name);
+      CHECK(std::memcmp(a.indices, b.indices, (size_t) a.indexCount * a.indexSize) == 0, name);
+      CHECK(std::memcmp(a.levels, b.levels, a.levelCount * sizeof(ppgso::MeshLevel)) == 0, name);
+      CHECK(b.indexSize == (b.vertexCount <= 0x10000 ? 2u : 4u), name);
+    }
+  }
+
+  void testPacking() {
+    ppgso::Vertex vertex{{1.5f, -2.25f, 1000.125f}, {0.25f, 0.75f}, {0, 3, -4}};
+    auto unpacked = ppgso::unpack(ppgso::pack(vertex));
+
+    // Positions stay exact, texture coordinates are halfs and normals are normalized to 10 bits
+    CHECK(unpacked.position == vertex.position, "packing");
+    CHECK(unpacked.texCoord == vertex.texCoord, "packing");
+    CHECK(glm::length(unpacked.normal - glm::vec3(0, 0.6f, -0.8f)) < 0.005f, "packing");
+  }
+
+  struct Item {
+    explicit Item(int value) : value{value} {}
+    virtual ~Item() = default;
+    int value;
+  };
+
+  struct NamedItem : Item {
+    using Item::Item;
+  };
+
+  void testSlotMap() {
+    SlotMap<Item> items;
+    std::vector<SlotHandle<Item>> handles;
+    for (int i = 0; i < 5; i++)
+      handles.push_back(items.insert(std::make_unique<Item>(i)));
+    SlotHandle<NamedItem> named = items.insert(std::make_unique<NamedItem>(5), "named");
+    CHECK(items.size() == 6 && items.find<NamedItem>("named") == items.get(named), "slot map");
+
+    // Removal moves the last element into the freed place
+    auto revision = items.revision();
+    CHECK(items.erase(handles[1]), "slot map");
+    CHECK(items.revision() != revision, "slot map");
+    CHECK(!items.contains(handles[1]) && items.get(handles[1]) == nullptr, "slot map");
+    CHECK(!items.erase(handles[1]), "slot map");
+    std::vector<int> packed;
+    for (auto &item : items)
+      packed.push_back(item->value);
+    CHECK((packed == std::vector<int>{0, 5, 2, 3, 4}), "slot map");
+    CHECK(items.get(named) && items.get(named)->value == 5, "slot map");
+    CHECK(items.handleAt(1).index == named.index && items.handleAt(1).generation == named.generation, "slot map");
+
+    // A reused slot gets a new generation, the old handle stays stale
+    auto reused = items.insert(std::make_unique<Item>(6));
+    CHECK(reused.index == handles[1].index && reused.generation != handles[1].generation, "slot map");
+    CHECK(items.get(handles[1]) == nullptr && items.get(reused)->value == 6, "slot map");
+
+    // Names stop resolving once their element is gone
+    items.erase(named);
+    CHECK(items.find("named") == nullptr, "slot map");
+    for (int i : {0, 2, 3, 4})
+      CHECK(items.get(handles[i]) && items.get(handles[i])->value == i, "slot map");
+    CHECK(items.size() == 5, "slot map");
+  }
+
+  struct Sphere {
+    glm::vec3 center;
+    float radius;
+    int32_t proxy;
+    bool live;
+  };
+
+  std::vector<uint32_t> sorted(std::vector<uint32_t> ids) {
+    std::sort(ids.begin(), ids.end());
+    return ids;
+  }
+
+  void testBoundingVolumeHierarchy() {
+    std::mt19937 generator(7);
+    std::uniform_real_distribution<float> coordinate(-100, 100), size(0.1f, 5);
+
+    BoundingVolumeHierarchy tree;
+    std::vector<Sphere> spheres(300);
+    for (uint32_t i = 0; i < spheres.size(); i++) {
+      auto &sphere = spheres[i];
+      sphere.center = {coordinate(generator), coordinate(generator), coordinate(generator)};
+      sphere.radius = size(generator);
+      sphere.proxy = tree.insert(i, sphere.center, sphere.radius);
+      sphere.live = true;
+    }
+
+    // Remove every third leaf, nudge some inside their margin and move others far away
+    for (uint32_t i = 0; i < spheres.size(); i++) {
+      auto &sphere = spheres[i];
+      if (i % 3 == 0) {
+        tree.remove(sphere.proxy);
+        sphere.live = false;
+      } else if (i % 3 == 1) {
+        sphere.center += glm::vec3{0.1f, -0.1f, 0.1f};
+        CHECK(!tree.move(sphere.proxy, sphere.center, sphere.radius), "bvh");
+      } else {
+        sphere.center = {coordinate(generator), coordinate(generator), coordinate(generator)};
+        CHECK(tree.move(sphere.proxy, sphere.center, sphere.radius), "bvh");
+      }
+    }
+    CHECK(tree.size() == 200, "bvh");
+
+    // Every query is compared with testing all live spheres one by one
+    Frustum frustum;
+    frustum.extract(glm::perspective(glm::radians(60.0f), 1.5f, 0.1f, 150.0f) *
+                    glm::lookAt(glm::vec3{-20, 10, 30}, glm::vec3{10, 0, -10}, glm::vec3{0, 1, 0}));
+    glm::vec3 boxMin{-30, -50, -20}, boxMax{40, 10, 60};
+    // The ray is aimed at a live leaf so it hits at least one
+    glm::vec3 origin{-120, 3, -4}, direction = glm::normalize(spheres[2].center - origin);
+
+    std::vector<uint32_t> visible, overlapping;
+    std::vector<std::pair<float, uint32_t>> hits;
+    for (uint32_t i = 0; i < spheres.size(); i++) {
+      auto &sphere = spheres[i];
+      if (!sphere.live) continue;
+      if (frustum.intersects(sphere.center, sphere.radius))
+        visible.push_back(i);
+
+      auto closest = glm::clamp(sphere.center, boxMin, boxMax) - sphere.center;
+      if (glm::dot(closest, closest) <= sphere.radius * sphere.radius)
+        overlapping.push_back(i);
+
+      auto offset = sphere.center - origin;
+      auto along = glm::dot(offset, direction);
+      auto distance2 = glm::dot(offset, offset) - along * along;
+      if (distance2 <= sphere.radius * sphere.radius && along + std::sqrt(sphere.radius * sphere.radius - distance2) >= 0)
+        hits.push_back({along - std::sqrt(sphere.radius * sphere.radius - distance2), i});
+    }
+    std::sort(hits.begin(), hits.end());
+    std::vector<uint32_t> hitIds;
+    for (auto &hit : hits)
+      hitIds.push_back(hit.second);
+    CHECK(!visible.empty() && !overlapping.empty() && !hitIds.empty(), "bvh");
+
+    std::vector<uint32_t> ids;
+    tree.query(frustum, ids);
+    CHECK(sorted(ids) == visible, "bvh frustum");
+    ids.clear();
+    tree.overlaps(boxMin, boxMax, ids);
+    CHECK(sorted(ids) == overlapping, "bvh box");
+    ids.clear();
+    tree.raycast(origin, direction, ids);
+    CHECK(ids == hitIds, "bvh ray");
+
+    // Ids follow setId, cleared trees find nothing
+    auto &first = spheres[1];
+    tree.setId(first.proxy, 1000);
+    ids.clear();
+    tree.overlaps(first.center, first.center, ids);
+    CHECK(std::find(ids.begin(), ids.end(), 1000u) != ids.end() && std::find(ids.begin(), ids.end(), 1u) == ids.end(), "bvh");
+    tree.clear();
+    ids.clear();
+    tree.overlaps(glm::vec3{-1000}, glm::vec3{1000}, ids);
+    CHECK(tree.size() == 0 && ids.empty(), "bvh");
+  }
+
+  void testParticleStore() {
+    ParticleStore store;
+    store.resize(4);
+
+    // Particles are told apart by their rotation
+    CHECK(store.spawn({0, 0, 0}, {0, 0, 0}, {1, 1, 1, 1}, 0, 99), "particles");
+    for (int i = 0; i < 4; i++)
+      CHECK(store.spawn({0, 0, 0}, {0, 0, 0}, {1, 1, 1, 1}, 1, (float) i), "particles");
+    CHECK(store.alive() == 4, "particles");
+    CHECK(!store.spawn({0, 0, 0}, {0, 0, 0}, {1, 1, 1, 1}, 1, 4) && store.droppedSpawns() == 1, "particles");
+
+    // Killing moves the last live particle into the slot
+    store.kill(1);
+    CHECK(store.alive() == 3 && store.rotation[1] == 3 && store.rotation[0] == 0 && store.rotation[2] == 2, "particles");
+    store.kill(2);
+    CHECK(store.alive() == 2 && store.rotation[0] == 0 && store.rotation[1] == 3, "particles");
+
+    // Large stores are integrated in chunks, only the particles that run out of life are killed
+    const size_t COUNT = 10001;
+    store.resize(COUNT);
+    CHECK(store.alive() == 0 && store.capacity() == COUNT, "particles");
+    for (size_t i = 0; i < COUNT; i++)
+      store.spawn({(float) i, 0, 0}, {1, 2, 3}, {1, 1, 1, 1}, i % 3 == 0 ? 0.05f : 1.0f, (float) i);
+
+    const float dt = 0.1f, drag = -2;
+    store.integrate(dt, drag);
+    CHECK(store.alive() == COUNT - (COUNT + 2) / 3, "particles");
+
+    std::vector<bool> seen(COUNT, false);
+    for (size_t p = 0; p < store.alive(); p++) {
+      auto i = (size_t) store.rotation[p];
+      CHECK(i % 3 != 0 && !seen[i], "particles");
+      seen[i] = true;
+      CHECK(std::abs(store.life[p] - (1 - dt)) < 1e-6f && std::abs(store.colorA[p] - (1 - dt)) < 1e-6f, "particles");
+      CHECK(std::abs(store.positionX[p] - (i + dt)) < 1e-3f && std::abs(store.positionY[p] - 2 * dt) < 1e-6f &&
+            std::abs(store.positionZ[p] - 3 * dt) < 1e-6f, "particles");
+      CHECK(std::abs(store.velocityY[p] - (2 + drag * dt)) < 1e-6f && store.velocityX[p] == 1, "particles");
+    }
+  }
+
+  void testFixedTimestep() {
+    // A tick of a quarter second keeps all the sums exact
+    FixedTimestep timestep(4, 5);
+    CHECK(timestep.tickTime() == 0.25f, "timestep");
+    CHECK(timestep.advance(0.1f) == 0 && std::abs(timestep.alpha() - 0.4f) < 1e-6f, "timestep");
+    CHECK(timestep.advance(0.4f) == 2 && std::abs(timestep.alpha()) < 1e-6f, "timestep");
+    CHECK(timestep.advance(-1) == 0, "timestep");
+
+    // A long frame runs at most the tick limit, the rest is dropped except for one tick
+    CHECK(timestep.advance(10) == 5 && timestep.alpha() == 1, "timestep");
+    CHECK(timestep.advance(0) == 1 && timestep.alpha() == 0, "timestep");
+
+    // Time already accumulated is kept when the rate changes
+    CHECK(timestep.advance(0.125f) == 0 && timestep.alpha() == 0.5f, "timestep");
+    timestep.setTickRate(8);
+    CHECK(timestep.alpha() == 1 && timestep.advance(0) == 1, "timestep");
+
+    // Short frames add up to the same number of ticks as the time they cover
+    FixedTimestep steady(60, 5);
+    std::mt19937 generator(3);
+    std::uniform_real_distribution<float> frame(0.001f, 0.03f);
+    double total = 0;
+    long ticks = 0;
+    for (int i = 0; i < 10000; i++) {
+      auto frameTime = frame(generator);
+      total += frameTime;
+      ticks += steady.advance(frameTime);
+    }
+    CHECK(std::abs(ticks - total * 60) <= 1, "timestep");
+  }
+
+  void testRandom() {
+    // Seeds derived from keys do not depend on how many generators were created before
+    auto first = Random::seedFor(7);
+    Random::nextSeed();
+    CHECK(Random::seedFor(7) == first && Random::seedFor(8) != first, "random");
+
+    // A new base changes the derived seeds and restarts the sequence
+    Random::setSeedBase(42);
+    auto seed = Random::nextSeed();
+    CHECK(Random::seedFor(7) != first, "random");
+    Random::setSeedBase(42);
+    CHECK(Random::nextSeed() == seed, "random");
+
+    // Equal seeds give equal single values and batches
+    Random a(seed), b(seed);
+    std::vector<float> valuesA(11), valuesB(11);
+    a.fill(valuesA.data(), valuesA.size(), -1, 1);
+    b.fill(valuesB.data(), valuesB.size(), -1, 1);
+    CHECK(valuesA == valuesB && a.next() == b.next(), "random");
+    for (auto value : valuesA)
+      CHECK(value >= -1 && value < 1, "random");
+    for (int i = 0; i < 1000; i++) {
+      auto value = a.range(3, 9);
+      CHECK(value >= 3 && value < 9, "random");
+    }
+  }
+
+  struct Placed : Object {
+    bool update(Scene &, float) override { return false; }
+    void render(Scene &) override {}
+  };
+
+  // Reference matrix built by glm, the batched path must match it
+  glm::mat4 reference(const Object &object) {
+    return glm::translate(glm::mat4{1}, object.position) * glm::orientate4(object.rotation) *
+           glm::scale(glm::mat4{1}, object.scale);
+  }
+
+  bool close(const glm::vec4 &a, const glm::vec4 &b) {
+    return glm::length(a - b) <= 1e-4f;
+  }
+
+  bool close(const glm::mat4 &a, const glm::mat4 &b) {
+    for (int c = 0; c < 4; c++)
+      if (!close(a[c], b[c])) return false;
+    return true;
+  }
+
+  void testTransformSystem() {
+    std::mt19937 generator(11);
+    std::uniform_real_distribution<float> coordinate(-10, 10), angle(-3, 3), size(0.5f, 2);
+
+    // Enough objects for several batches of four and a remainder, every other one attached to an earlier one
+    SceneObjects objects;
+    std::vector<SlotHandle<Object>> handles;
+    for (int i = 0; i < 11; i++) {
+      auto object = std::make_unique<Placed>();
+      object->position = {coordinate(generator), coordinate(generator), coordinate(generator)};
+      object->rotation = {angle(generator), angle(generator), angle(generator)};
+      object->scale = {size(generator), size(generator), size(generator)};
+      if (i % 2 == 1)
+        object->parent = handles[i / 2];
+      handles.push_back(objects.insert(std::move(object)));
+    }
+    objects.get(handles[10])->staticTransform = true;
+
+    auto world = [&](int i) {
+      auto object = objects.get(handles[i]);
+      auto matrix = reference(*object);
+      for (auto parent = objects.get(object->parent); parent; parent = objects.get(parent->parent))
+        matrix = reference(*parent) * matrix;
+      return matrix;
+    };
+
+    TransformSystem transforms;
+    transforms.update(objects);
+    CHECK(transforms.rebuilt() == 11, "transforms");
+    for (int i = 0; i < 11; i++) {
+      auto object = objects.get(handles[i]);
+      CHECK(close(object->modelMatrix, world(i)), "transforms " + std::to_string(i));
+      CHECK(close(TransformSystem::compose(object->position, object->rotation, object->scale), reference(*object)),
+            "transforms " + std::to_string(i));
+    }
+
+    // Nothing changed, nothing is rebuilt
+    transforms.update(objects);
+    CHECK(transforms.rebuilt() == 0, "transforms");
+
+    // Moving object 1 rebuilds it and its children 3 and 7, the static 10 stays as it was built
+    auto moved = objects.get(handles[1]);
+    auto before = moved->modelMatrix;
+    moved->position += glm::vec3{1, 2, 3};
+    objects.get(handles[10])->position += glm::vec3{1, 0, 0};
+    transforms.update(objects);
+    CHECK(transforms.rebuilt() == 3, "transforms");
+    for (int i : {1, 3, 7})
+      CHECK(close(objects.get(handles[i])->modelMatrix, world(i)), "transforms " + std::to_string(i));
+    CHECK(!close(objects.get(handles[10])->modelMatrix, world(10)), "transforms");
+
+    // Interpolation shows the previous matrix at the start of a tick and is undone by restore
+    auto after = moved->modelMatrix;
+    transforms.interpolate(objects, 0);
+    CHECK(close(moved->modelMatrix, before), "transforms");
+    transforms.restore();
+    CHECK(moved->modelMatrix == after, "transforms");
+    transforms.interpolate(objects, 0.5f);
+    CHECK(close(moved->modelMatrix[3], (before[3] + after[3]) * 0.5f), "transforms");
+    transforms.restore();
+    CHECK(moved->modelMatrix == after, "transforms");
+  }
+
+  void testSort() {
+    std::mt19937_64 generator(42);
+    for (size_t count : {0, 1, 2, 100, 5000}) {
+      // Keys share their upper bytes the way packets of one pass and shader do, some keys are equal
+      std::vector<uint64_t> keys(count);
+      for (auto &key : keys)
+        key = (1ull << 62) | ((generator() % 4) << 40) | (generator() & 0xFFFFFFFFFull) % (count + 1);
+
+      std::vector<uint32_t> order(count);
+      std::iota(order.begin(), order.end(), 0);
+      std::vector<uint32_t> expected = order;
+      std::stable_sort(expected.begin(), expected.end(), [&keys](uint32_t a, uint32_t b) { return keys[a] < keys[b]; });
+
+      auto sorted = keys;
+      std::vector<uint64_t> scratchKeys;
+      std::vector<uint32_t> scratch;
+      RenderQueue::sort(sorted, order, scratchKeys, scratch);
+
+      auto context = std::to_string(count) + " keys";
+      CHECK(order == expected, context);
+      CHECK(std::is_sorted(sorted.begin(), sorted.end()), context);
+      for (size_t i = 0; i < std::min(sorted.size(), order.size()); i++)
+        CHECK(sorted[i] == keys[order[i]], context);
+    }
+  }
+}
+
+int main(int argc, char *argv[]) {
+  if (argc != 2) {
+    std::cerr << "Usage: " << argv[0] << " data_directory" << std::endl;
+    return EXIT_FAILURE;
+  }
+  std::string directory = argv[1];
+  directory += '/';
+
+  try {
+    testScene(directory, "alley.scene");
+    testScene(directory, "disco.scene");
+    testLevels(directory, "cube.obj", false);
+    testLevels(directory, "garbageBin.obj", true);
+    testMesh(directory, "cube.obj");
+    testMesh(directory, "garbageBin.obj");
+    testPacking();
+    testSort();
+    testSlotMap();
+    testBoundingVolumeHierarchy();
+    testParticleStore();
+    testFixedTimestep();
+    testTransformSystem();
+    testRandom();
+  } catch (std::exception &e) {
+    std::cerr << e.what() << std::endl;
+    return EXIT_FAILURE;
+  }
+
+  if (failures > 0) {
+    std::cerr << failures << " checks failed" << std::endl;
+    return EXIT_FAILURE;
+  }
+  std::cout << "All checks passed" << std::endl;
+  return EXIT_SUCCESS;
+}
@@ -0,0 +1,36 @@
+// Tool scene_compiler
+// - Converts text .scene descriptions into compiled binary .scn files
+// - Instances are grouped by mesh and texture at compile time, so loading a scene is one pass over contiguous tables
+// - Batches with meshes small enough to merge are marked, the meshes are read from the directory of the input file
+// - SceneData::load, called by the SceneManager, memory maps the .scn file next to the requested .scene file and
+//   falls back to parsing the text
+// - Usage: scene_compiler input.scene [output.scn]
+
+#include <iostream>
+#include "src/project/SceneData.h"
+
+int main(int argc, char *argv[]) {
+  if (argc < 2 || argc > 3) {
+    std::cerr << "Usage: " << argv[0] << " input.scene [output.scn]" << std::endl;
+    return EXIT_FAILURE;
+  }
+
+  std::string input = argv[1];
+  std::string output = argc == 3 ? argv[2] : SceneData::binaryPath(input);
+
+  try {
+    auto data = SceneData::loadText(input);
+    data.markBatchable(input.substr(0, input.find_last_of("/\\") + 1));
+    data.saveBinary(output);
+
+    std::cout << input << " -> " << output << " (" << data.instances.count << " instances in "
+              << data.batches.count << " batches, " << data.nodes.count << " nodes, "
+              << data.lamps.count + data.emitters.count + data.characters.count << " other objects, "
+              << data.lights.count << " lights)" << std::endl;
+  } catch (std::exception &e) {
+    std::cerr << e.what() << std::endl;
+    return EXIT_FAILURE;
+  }
+
+  return EXIT_SUCCESS;
+}